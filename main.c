@@ -4,19 +4,39 @@
  * Compile & run:
  *  cmake --build ./build --config Release --target all --
  *  cd ./build
- *  ./turing
+ *  ./turing                          (default machine)
+ *  ./turing ../tms/bb4.tm            (single machine)
+ *  ./turing ../tms/bb3.tm ../tms/bb4.tm ../tms/bb5c.tm   (grid of machines, click or Enter to expand one)
+ *  ./turing -t 100000 ../tms/bb5c.tm (tape length, default TM_DEFAULT_TAPE_LENGTH)
  *
  */
 
 #include "visualizer.h"
+#include <stdlib.h>
+#include <string.h>
 
-int main()
+int main(int argc, char** argv)
 {
+    tm_tape_numeric_t tape_length = TM_DEFAULT_TAPE_LENGTH;
+    if (argc > 2 && strcmp(argv[1], "-t") == 0) {
+        tape_length = (tm_tape_numeric_t)strtoul(argv[2], NULL, 10);
+        argc -= 2;
+        argv += 2;
+    }
+
     display_tm_visualization_window();
-    //load_visualization_tm("../tms/bb2.tm");
-    //load_visualization_tm("../tms/bb3.tm");
-    //load_visualization_tm("../tms/bb4.tm");
-    //load_visualization_tm("../tms/bb5c.tm");
-    load_visualization_tm("../tms/bb6c.tm");
+    if (argc > 2) {
+        load_visualization_tm_grid(argv + 1, argc - 1, tape_length);
+    }
+    else if (argc == 2) {
+        load_visualization_tm(argv[1], tape_length);
+    }
+    else {
+        //load_visualization_tm("../tms/bb2.tm", tape_length);
+        //load_visualization_tm("../tms/bb3.tm", tape_length);
+        //load_visualization_tm("../tms/bb4.tm", tape_length);
+        //load_visualization_tm("../tms/bb5c.tm", tape_length);
+        load_visualization_tm("../tms/bb6c.tm", tape_length);
+    }
     return 0;
 }
@@ -0,0 +1,573 @@
+/**
+ * Differential testing harness
+ *
+ * Runs the reference tm_make_transition() path and every alternative engine side by side
+ * on the same machines and compares state, head, tape and turing_machine_stat_t at checkpoints.
+ * Machines come from *.tm files, from exhaustive enumeration of all 2-state 2-symbol machines
+ * and from a seeded random generator. A diverging machine is shrunk to the smallest machine and
+ * step count that still reproduce the divergence, printed in *.tm format, and the exit code is 1.
+ *
+ * Compile & run:
+ *  cmake --build ./build --config Release --target tm_difftest --
+ *  cd ./build
+ *  ./tm_difftest                          (shipped tms files, enumeration, random machines)
+ *  ./tm_difftest -r 100000 -s 7 a.tm b.tm (custom files, 100000 random machines, seed 7)
+ *
+ * Options:
+ *  -r <count>  number of random machines (default TM_DIFFTEST_DEFAULT_RANDOM)
+ *  -s <seed>   random generator seed
+ *  -n <steps>  step budget per machine (default TM_DIFFTEST_DEFAULT_STEPS)
+ *  -c <steps>  checkpoint interval (default TM_DIFFTEST_DEFAULT_CHECKPOINT)
+ *  -t <cells>  tape length of file and enumerated machines, longest tape of random machines (default TM_DEFAULT_TAPE_LENGTH)
+ *  -E          skip enumeration
+ */
+
+#include "turing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef TM_STAT_INTERFACE
+#error "tm_difftest requires TM_STAT_INTERFACE"
+#endif
+
+#define TM_DIFFTEST_DEFAULT_RANDOM 20000U
+#define TM_DIFFTEST_DEFAULT_STEPS 2000U
+#define TM_DIFFTEST_DEFAULT_CHECKPOINT 64U
+#define TM_DIFFTEST_FILE_STEPS 1000000U
+#define TM_DIFFTEST_RANDOM_MAX_STATES 6U
+#define TM_DIFFTEST_RANDOM_MAX_SYMBOLS 4U
+#define TM_DIFFTEST_RANDOM_MIN_TAPE_LENGTH 8U
+
+typedef tm_run_result_t (*tm_difftest_run_fn)(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_stat_step_numeric_t max_steps);
+
+typedef struct {
+    char* name;
+    tm_difftest_run_fn run;
+} tm_difftest_engine_t;
+
+#ifdef TM_SUSPEND_INTERFACE
+/**
+ * tm_run() on a machine that went through tm_suspend() and tm_resume() before every checkpoint
+*/
+static tm_run_result_t tm_difftest_run_resumed(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_stat_step_numeric_t max_steps) {
+    static unsigned char* buffer = NULL;
+    static size_t buffer_size = 0;
+    size_t size = tm_suspend_size(tm, tm_stat);
+    if (size > buffer_size) {
+        buffer = realloc(buffer, size);
+        if (buffer == NULL) {
+            tm_error("Could not allocate suspend buffer\n");
+        }
+        buffer_size = size;
+    }
+    tm_suspend(tm, tm_stat, buffer);
+
+    // Clobber everything but the storage, which is reused
+    memset(tm->tape, 0xA5, tm->tape_length * sizeof(tm_symbol_t));
+    memset(tm->transition_bundles[0].transitions, 0xA5, (size_t)tm->num_states * tm->num_symbols * sizeof(tm_state_transition_t));
+    memset(tm_stat->reads, 0xA5, tm->num_symbols * sizeof(tm_stat_read_numeric_t));
+    memset(tm_stat->writes, 0xA5, tm->num_symbols * sizeof(tm_stat_write_numeric_t));
+    memset(tm_stat->state_visits, 0xA5, tm->num_states * sizeof(tm_stat_step_numeric_t));
+    tm->head = tm->state = 0xA5;
+    tm_stat->num_steps = tm_stat->min_head = tm_stat->max_head = 0xA5;
+
+    tm_resume(tm, tm_stat, NULL, buffer, 0);
+    return tm_run(tm, tm_stat, max_steps);
+}
+#endif
+
+/**
+ * Alternative engines checked against the reference path.
+ * Add new execution paths here.
+*/
+static tm_difftest_engine_t tm_difftest_engines[] = {
+    { "tm_run", tm_run },
+    #ifdef TM_SUSPEND_INTERFACE
+    { "tm_resume + tm_run", tm_difftest_run_resumed },
+    #endif
+};
+#define TM_DIFFTEST_NUM_ENGINES (sizeof(tm_difftest_engines) / sizeof(tm_difftest_engines[0]))
+
+typedef struct {
+    unsigned long machines;
+    unsigned long steps;
+    unsigned long divergences;
+} tm_difftest_totals_t;
+
+static unsigned long long tm_difftest_rng_state = 0x9E3779B97F4A7C15ULL;
+
+// Machines under test, storage of a single run (reset per run) and of the shrinker (reset per divergence)
+static tm_arena_t tm_difftest_machine_arena;
+static tm_arena_t tm_difftest_run_arena;
+static tm_arena_t tm_difftest_shrink_arena;
+
+static unsigned int tm_difftest_rand(unsigned int bound) {
+    // xorshift64*
+    tm_difftest_rng_state ^= tm_difftest_rng_state >> 12;
+    tm_difftest_rng_state ^= tm_difftest_rng_state << 25;
+    tm_difftest_rng_state ^= tm_difftest_rng_state >> 27;
+    return (unsigned int)((tm_difftest_rng_state * 0x2545F4914F6CDD1DULL) >> 32) % bound;
+}
+
+/**
+ * Copies the dimensions and transitions of src into dst, whose storage must be at least as large
+*/
+static void tm_difftest_copy(turing_machine_t* dst, const turing_machine_t* src) {
+    dst->num_states = src->num_states;
+    dst->num_symbols = src->num_symbols;
+    for (tm_state_t i = 0; i < src->num_states; i++) {
+        dst->transition_bundles[i].bundle_size = src->num_symbols;
+        memcpy(dst->transition_bundles[i].transitions, src->transition_bundles[i].transitions, src->num_symbols * sizeof(tm_state_transition_t));
+    }
+    #ifdef TM_GUARDS
+    dst->transition_bundles_initialized = TM_GUARD_OK;
+    #endif
+}
+
+/**
+ * Allocates dst from the arena with the dimensions of src and copies src into it
+*/
+static void tm_difftest_clone(turing_machine_t* dst, tm_arena_t* arena, const turing_machine_t* src) {
+    tm_alloc(dst, arena, src->num_states, src->num_symbols, src->tape_length);
+    tm_difftest_copy(dst, src);
+    tm_init(dst);
+}
+
+/**
+ * Prepares a copy of the machine for a run - fresh tape, head and state, same transition bundles
+*/
+static void tm_difftest_reset(turing_machine_t* dst, const turing_machine_t* machine, turing_machine_stat_t* tm_stat) {
+    tm_difftest_clone(dst, &tm_difftest_run_arena, machine);
+    tm_stat_alloc(tm_stat, &tm_difftest_run_arena, dst);
+    tm_stat_init(tm_stat, dst);
+}
+
+/**
+ * Reference path - tm_make_transition() one step at a time.
+ * Transitions that would make tm_make_transition() exit are detected beforehand.
+*/
+static tm_run_result_t tm_difftest_reference_run(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_stat_step_numeric_t max_steps) {
+    for (tm_stat_step_numeric_t i = 0; i < max_steps; i++) {
+        if (tm_get_status(tm) == TM_STATUS_HALTED) {
+            break;
+        }
+        tm_state_transition_t* t = tm_get_transition(tm);
+        if ((t->head_direction == TM_HEAD_LEFT && tm->head == 0x0) || (t->head_direction == TM_HEAD_RIGHT && tm->head == tm->tape_length - 1)) {
+            return TM_RUN_TAPE_BOUNDARY;
+        }
+        tm_make_transition(tm, tm_stat);
+    }
+    return tm_get_status(tm) == TM_STATUS_HALTED ? TM_RUN_HALTED : TM_RUN_BUDGET_EXHAUSTED;
+}
+
+/**
+ * @returns 0 if both runs are in the same configuration, otherwise a short description of the first mismatch
+*/
+static const char* tm_difftest_compare(turing_machine_t* ref, turing_machine_stat_t* ref_stat, tm_run_result_t ref_result,
+                                       turing_machine_t* alt, turing_machine_stat_t* alt_stat, tm_run_result_t alt_result) {
+    if (ref_result != alt_result) {
+        return "run result";
+    }
+    if (ref->state != alt->state) {
+        return "state";
+    }
+    if (ref->head != alt->head) {
+        return "head";
+    }
+    if (memcmp(ref->tape, alt->tape, ref->tape_length * sizeof(tm_symbol_t)) != 0) {
+        return "tape";
+    }
+    if (ref_stat->num_steps != alt_stat->num_steps) {
+        return "stat num_steps";
+    }
+    if (ref_stat->min_head != alt_stat->min_head || ref_stat->max_head != alt_stat->max_head) {
+        return "stat head range";
+    }
+    for (tm_symbol_t i = 0; i < ref->num_symbols; i++) {
+        if (ref_stat->reads[i] != alt_stat->reads[i]) {
+            return "stat reads";
+        }
+        if (ref_stat->writes[i] != alt_stat->writes[i]) {
+            return "stat writes";
+        }
+    }
+    for (tm_state_t i = 0; i < ref->num_states; i++) {
+        if (ref_stat->state_visits[i] != alt_stat->state_visits[i]) {
+            return "stat state_visits";
+        }
+    }
+    return 0;
+}
+
+/**
+ * Runs the machine on the reference path and on the engine for at most max_steps steps, comparing every checkpoint steps.
+ *
+ * @param divergence_step If not null, receives the step budget consumed when the divergence was observed
+ * @param num_steps If not null, receives the number of reference steps executed
+ * @returns 0 if no divergence was observed, otherwise a short description of the mismatch
+*/
+static const char* tm_difftest_run(const turing_machine_t* machine, tm_difftest_engine_t* engine, tm_stat_step_numeric_t max_steps, tm_stat_step_numeric_t checkpoint,
+                                   tm_stat_step_numeric_t* divergence_step, tm_stat_step_numeric_t* num_steps) {
+    turing_machine_t ref, alt;
+    turing_machine_stat_t ref_stat, alt_stat;
+    tm_arena_reset(&tm_difftest_run_arena);
+    tm_difftest_reset(&ref, machine, &ref_stat);
+    tm_difftest_reset(&alt, machine, &alt_stat);
+
+    const char* mismatch = 0;
+    tm_stat_step_numeric_t done = 0;
+    while (done < max_steps) {
+        tm_stat_step_numeric_t chunk = max_steps - done < checkpoint ? max_steps - done : checkpoint;
+        tm_run_result_t ref_result = tm_difftest_reference_run(&ref, &ref_stat, chunk);
+        tm_run_result_t alt_result = engine->run(&alt, &alt_stat, chunk);
+        done += chunk;
+        mismatch = tm_difftest_compare(&ref, &ref_stat, ref_result, &alt, &alt_stat, alt_result);
+        if (mismatch || ref_result != TM_RUN_BUDGET_EXHAUSTED) {
+            break;
+        }
+    }
+
+    if (divergence_step) {
+        *divergence_step = done;
+    }
+    if (num_steps) {
+        *num_steps = ref_stat.num_steps;
+    }
+    return mismatch;
+}
+
+/**
+ * Checks whether the machine diverges within max_steps when the engine runs in calls of checkpoint steps, the call
+ * size that found the divergence. The engine is never sliced into smaller calls, so divergences that only show up
+ * in batched runs are kept. If it diverges, max_steps is bisected down to the smallest budget found to diverge.
+ *
+ * @returns 1 if the machine still diverges within max_steps, updating max_steps to the divergent budget
+*/
+static int tm_difftest_still_diverges(const turing_machine_t* machine, tm_difftest_engine_t* engine, tm_stat_step_numeric_t* max_steps, tm_stat_step_numeric_t checkpoint) {
+    if (!tm_difftest_run(machine, engine, *max_steps, checkpoint, 0, 0)) {
+        return 0;
+    }
+    tm_stat_step_numeric_t passing = 0;
+    tm_stat_step_numeric_t diverging = *max_steps;
+    while (diverging - passing > 1) {
+        tm_stat_step_numeric_t middle = passing + (diverging - passing) / 2;
+        if (tm_difftest_run(machine, engine, middle, checkpoint, 0, 0)) {
+            diverging = middle;
+        }
+        else {
+            passing = middle;
+        }
+    }
+    *max_steps = diverging;
+    return 1;
+}
+
+/**
+ * Greedily shrinks a diverging machine: drops trailing states and symbols, then simplifies single transitions
+ * (next state to halt, write symbol to blank, head direction to right) while the divergence reproduces.
+ *
+ * @returns 0 if the machine doesn't diverge within max_steps in engine calls of checkpoint steps, so nothing could be shrunk
+*/
+static int tm_difftest_shrink(turing_machine_t* machine, tm_difftest_engine_t* engine, tm_stat_step_numeric_t* max_steps, tm_stat_step_numeric_t checkpoint) {
+    turing_machine_t candidate;
+    tm_difftest_clone(&candidate, &tm_difftest_shrink_arena, machine);
+    if (!tm_difftest_still_diverges(machine, engine, max_steps, checkpoint)) {
+        return 0;
+    }
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+
+        // Drop the last state, redirecting transitions into it to halt
+        if (machine->num_states > 1) {
+            tm_difftest_copy(&candidate, machine);
+            candidate.num_states--;
+            for (tm_state_t i = 0; i < candidate.num_states; i++) {
+                for (tm_symbol_t j = 0; j < candidate.num_symbols; j++) {
+                    tm_state_transition_t* t = &candidate.transition_bundles[i].transitions[j];
+                    if (t->state == candidate.num_states) {
+                        t->state = TM_HALT_STATE;
+                    }
+                }
+            }
+            if (tm_difftest_still_diverges(&candidate, engine, max_steps, checkpoint)) {
+                tm_difftest_copy(machine, &candidate);
+                changed = 1;
+                continue;
+            }
+        }
+
+        // Drop the last symbol, writing blank instead of it
+        if (machine->num_symbols > 1) {
+            tm_difftest_copy(&candidate, machine);
+            candidate.num_symbols--;
+            for (tm_state_t i = 0; i < candidate.num_states; i++) {
+                candidate.transition_bundles[i].bundle_size = candidate.num_symbols;
+                for (tm_symbol_t j = 0; j < candidate.num_symbols; j++) {
+                    tm_state_transition_t* t = &candidate.transition_bundles[i].transitions[j];
+                    if (t->write_symbol == candidate.num_symbols) {
+                        t->write_symbol = TM_BLANK_SYMBOL;
+                    }
+                }
+            }
+            if (tm_difftest_still_diverges(&candidate, engine, max_steps, checkpoint)) {
+                tm_difftest_copy(machine, &candidate);
+                changed = 1;
+                continue;
+            }
+        }
+
+        // Simplify single transitions
+        for (tm_state_t i = 0; i < machine->num_states; i++) {
+            for (tm_symbol_t j = 0; j < machine->num_symbols; j++) {
+                tm_state_transition_t* t = &machine->transition_bundles[i].transitions[j];
+                for (int k = 0; k < 3; k++) {
+                    tm_state_transition_t simplified = *t;
+                    if (k == 0) {
+                        simplified.state = TM_HALT_STATE;
+                    }
+                    else if (k == 1) {
+                        simplified.write_symbol = TM_BLANK_SYMBOL;
+                    }
+                    else {
+                        simplified.head_direction = TM_HEAD_RIGHT;
+                    }
+                    if (memcmp(&simplified, t, sizeof(tm_state_transition_t)) == 0) {
+                        continue;
+                    }
+                    tm_difftest_copy(&candidate, machine);
+                    candidate.transition_bundles[i].transitions[j] = simplified;
+                    if (tm_difftest_still_diverges(&candidate, engine, max_steps, checkpoint)) {
+                        *t = simplified;
+                        changed = 1;
+                    }
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * Dumps the machine in *.tm file format.
+ * Small machines use single character names (states A.., halt H, symbols 0.., L R),
+ * larger ones use comma-separated tuples (states q0.., halt h, symbols 0..).
+*/
+static void tm_difftest_print_machine(FILE* stream, const turing_machine_t* tm) {
+    int short_names = tm->num_states < 'H' - 'A' && tm->num_symbols <= 10;
+    fprintf(stream, "%u %u\n", (unsigned int)tm->num_states, (unsigned int)tm->num_symbols);
+    for (tm_state_t i = 0; i < tm->num_states; i++) {
+        if (short_names) {
+            fprintf(stream, i ? " %c" : "%c", 'A' + i);
+        }
+        else {
+            fprintf(stream, i ? " q%u" : "q%u", (unsigned int)i);
+        }
+    }
+    fprintf(stream, short_names ? "\nH\n" : "\nh\n");
+    for (tm_symbol_t i = 0; i < tm->num_symbols; i++) {
+        fprintf(stream, i ? " %u" : "%u", (unsigned int)i);
+    }
+    fprintf(stream, "\nL R\n");
+    for (tm_symbol_t j = 0; j < tm->num_symbols; j++) {
+        for (tm_state_t i = 0; i < tm->num_states; i++) {
+            const tm_state_transition_t* t = &tm->transition_bundles[i].transitions[j];
+            char direction = t->head_direction == TM_HEAD_LEFT ? 'L' : 'R';
+            if (short_names) {
+                fprintf(stream, i ? " %u%c%c" : "%u%c%c", (unsigned int)t->write_symbol, direction, t->state == TM_HALT_STATE ? 'H' : 'A' + t->state);
+            }
+            else if (t->state == TM_HALT_STATE) {
+                fprintf(stream, i ? " %u,%c,h" : "%u,%c,h", (unsigned int)t->write_symbol, direction);
+            }
+            else {
+                fprintf(stream, i ? " %u,%c,q%u" : "%u,%c,q%u", (unsigned int)t->write_symbol, direction, (unsigned int)t->state);
+            }
+        }
+        fprintf(stream, "\n");
+    }
+}
+
+/**
+ * Checks one machine against every engine, shrinking and reporting any divergence
+*/
+static void tm_difftest_check(const turing_machine_t* machine, char* origin, tm_stat_step_numeric_t max_steps, tm_stat_step_numeric_t checkpoint, tm_difftest_totals_t* totals) {
+    turing_machine_t shrunk;
+    // Every engine replays the same reference run, which stops early only at a divergence
+    tm_stat_step_numeric_t reference_steps = 0;
+    for (size_t e = 0; e < TM_DIFFTEST_NUM_ENGINES; e++) {
+        tm_difftest_engine_t* engine = &tm_difftest_engines[e];
+        tm_stat_step_numeric_t divergence_step, num_steps;
+        const char* mismatch = tm_difftest_run(machine, engine, max_steps, checkpoint, &divergence_step, &num_steps);
+        if (num_steps > reference_steps) {
+            reference_steps = num_steps;
+        }
+        if (!mismatch) {
+            continue;
+        }
+        totals->divergences++;
+        fprintf(stderr, "DIVERGENCE: engine %s, %s, %s mismatch at checkpoint step %u\n", engine->name, origin, mismatch, divergence_step);
+
+        tm_arena_reset(&tm_difftest_shrink_arena);
+        tm_difftest_clone(&shrunk, &tm_difftest_shrink_arena, machine);
+        tm_stat_step_numeric_t shrunk_steps = divergence_step;
+        if (!tm_difftest_shrink(&shrunk, engine, &shrunk_steps, checkpoint)) {
+            tm_difftest_print_machine(stderr, machine);
+            tm_errorf("Divergence of engine %s on %s does not reproduce within %u steps\n", engine->name, origin, shrunk_steps);
+        }
+        mismatch = tm_difftest_run(&shrunk, engine, shrunk_steps, checkpoint, 0, 0);
+        if (!mismatch) {
+            tm_difftest_print_machine(stderr, &shrunk);
+            tm_errorf("Shrunk machine of engine %s on %s does not diverge within %u steps\n", engine->name, origin, shrunk_steps);
+        }
+        fprintf(stderr, "Shrunk to %u steps in engine calls of %u steps (%s mismatch):\n", shrunk_steps, checkpoint, mismatch);
+        tm_difftest_print_machine(stderr, &shrunk);
+    }
+    totals->steps += reference_steps;
+    totals->machines++;
+}
+
+static void tm_difftest_set_bundle_sizes(turing_machine_t* tm) {
+    for (tm_state_t i = 0; i < tm->num_states; i++) {
+        tm->transition_bundles[i].bundle_size = tm->num_symbols;
+        for (tm_symbol_t j = 0; j < tm->num_symbols; j++) {
+            tm->transition_bundles[i].transitions[j].read_symbol = j;
+        }
+    }
+}
+
+/**
+ * Enumerates all 2-state 2-symbol machines (12^4 transition tables)
+*/
+static void tm_difftest_enumerate(tm_tape_numeric_t tape_length, tm_stat_step_numeric_t max_steps, tm_stat_step_numeric_t checkpoint, tm_difftest_totals_t* totals) {
+    turing_machine_t tm;
+    tm_arena_reset(&tm_difftest_machine_arena);
+    tm_alloc(&tm, &tm_difftest_machine_arena, 2, 2, tape_length);
+    tm_difftest_set_bundle_sizes(&tm);
+
+    const unsigned int num_choices = 2 * 2 * 3; // write symbol, head direction, next state (A, B, halt)
+    const unsigned int num_transitions = 4;
+    unsigned long total = 1;
+    for (unsigned int i = 0; i < num_transitions; i++) {
+        total *= num_choices;
+    }
+
+    for (unsigned long index = 0; index < total; index++) {
+        unsigned long code = index;
+        for (unsigned int k = 0; k < num_transitions; k++) {
+            tm_state_transition_t* t = &tm.transition_bundles[k / 2].transitions[k % 2];
+            unsigned int choice = code % num_choices;
+            code /= num_choices;
+            t->write_symbol = choice % 2;
+            t->head_direction = (choice / 2) % 2 ? TM_HEAD_RIGHT : TM_HEAD_LEFT;
+            t->state = choice / 4 == 2 ? TM_HALT_STATE : choice / 4;
+        }
+        char origin[64];
+        sprintf(origin, "enumerated machine #%lu", index);
+        tm_difftest_check(&tm, origin, max_steps, checkpoint, totals);
+    }
+}
+
+static void tm_difftest_random(unsigned long count, tm_tape_numeric_t max_tape_length, tm_stat_step_numeric_t max_steps, tm_stat_step_numeric_t checkpoint, tm_difftest_totals_t* totals) {
+    turing_machine_t tm;
+    if (max_tape_length < TM_DIFFTEST_RANDOM_MIN_TAPE_LENGTH) {
+        max_tape_length = TM_DIFFTEST_RANDOM_MIN_TAPE_LENGTH;
+    }
+    for (unsigned long n = 0; n < count; n++) {
+        tm_state_t num_states = 1 + tm_difftest_rand(TM_DIFFTEST_RANDOM_MAX_STATES);
+        tm_symbol_t num_symbols = 2 + tm_difftest_rand(TM_DIFFTEST_RANDOM_MAX_SYMBOLS - 1);
+        tm_tape_numeric_t tape_length = TM_DIFFTEST_RANDOM_MIN_TAPE_LENGTH + tm_difftest_rand(max_tape_length - TM_DIFFTEST_RANDOM_MIN_TAPE_LENGTH + 1);
+        tm_arena_reset(&tm_difftest_machine_arena);
+        tm_alloc(&tm, &tm_difftest_machine_arena, num_states, num_symbols, tape_length);
+        tm_difftest_set_bundle_sizes(&tm);
+        for (tm_state_t i = 0; i < tm.num_states; i++) {
+            for (tm_symbol_t j = 0; j < tm.num_symbols; j++) {
+                tm_state_transition_t* t = &tm.transition_bundles[i].transitions[j];
+                t->write_symbol = tm_difftest_rand(tm.num_symbols);
+                t->head_direction = tm_difftest_rand(2) ? TM_HEAD_RIGHT : TM_HEAD_LEFT;
+                // Roughly one halt transition per machine
+                unsigned int next = tm_difftest_rand(tm.num_states * tm.num_symbols + 1);
+                t->state = next == 0 ? TM_HALT_STATE : next % tm.num_states;
+            }
+        }
+        char origin[64];
+        sprintf(origin, "random machine #%lu", n);
+        tm_difftest_check(&tm, origin, max_steps, checkpoint, totals);
+    }
+}
+
+int main(int argc, char** argv) {
+    static char* default_paths[] = { "../tms/bb2.tm", "../tms/bb3.tm", "../tms/bb4.tm", "../tms/bb5c.tm", "../tms/bb6c.tm" };
+    unsigned long num_random = TM_DIFFTEST_DEFAULT_RANDOM;
+    unsigned long long seed = 1;
+    tm_stat_step_numeric_t max_steps = TM_DIFFTEST_DEFAULT_STEPS;
+    tm_stat_step_numeric_t checkpoint = TM_DIFFTEST_DEFAULT_CHECKPOINT;
+    tm_tape_numeric_t tape_length = TM_DEFAULT_TAPE_LENGTH;
+    int enumerate = 1;
+    char** paths = default_paths;
+    int num_paths = sizeof(default_paths) / sizeof(default_paths[0]);
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-E") == 0) {
+            enumerate = 0;
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-r") == 0) {
+            num_random = strtoul(argv[++i], NULL, 10);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) {
+            max_steps = (tm_stat_step_numeric_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-c") == 0) {
+            checkpoint = (tm_stat_step_numeric_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) {
+            tape_length = (tm_tape_numeric_t)strtoul(argv[++i], NULL, 10);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [-r count] [-s seed] [-n steps] [-c checkpoint] [-t cells] [-E] [file.tm ...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (i < argc) {
+        paths = argv + i;
+        num_paths = argc - i;
+    }
+    if (checkpoint == 0) {
+        checkpoint = 1;
+    }
+    if (tape_length == 0) {
+        tape_length = 1;
+    }
+    tm_difftest_rng_state ^= seed * 0xBF58476D1CE4E5B9ULL;
+    tm_arena_init(&tm_difftest_machine_arena, TM_ARENA_DEFAULT_BLOCK_SIZE);
+    tm_arena_init(&tm_difftest_run_arena, TM_ARENA_DEFAULT_BLOCK_SIZE);
+    tm_arena_init(&tm_difftest_shrink_arena, TM_ARENA_DEFAULT_BLOCK_SIZE);
+
+    tm_difftest_totals_t totals = { 0, 0, 0 };
+    clock_t start = clock();
+
+    turing_machine_t tm;
+    for (int p = 0; p < num_paths; p++) {
+        tm_arena_reset(&tm_difftest_machine_arena);
+        tm_from_file(&tm, &tm_difftest_machine_arena, paths[p], tape_length);
+        tm_difftest_check(&tm, paths[p], TM_DIFFTEST_FILE_STEPS, checkpoint, &totals);
+    }
+    if (enumerate) {
+        tm_difftest_enumerate(tape_length, max_steps, checkpoint, &totals);
+    }
+    tm_difftest_random(num_random, tape_length, max_steps, checkpoint, &totals);
+
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%lu machines, %lu reference steps, %lu divergences in %.2fs (%.0f machines/s)\n",
+           totals.machines, totals.steps, totals.divergences, seconds, seconds > 0 ? totals.machines / seconds : 0.0);
+    tm_arena_free(&tm_difftest_machine_arena);
+    tm_arena_free(&tm_difftest_run_arena);
+    tm_arena_free(&tm_difftest_shrink_arena);
+    return totals.divergences ? 1 : 0;
+}
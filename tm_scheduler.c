@@ -0,0 +1,264 @@
+#include "tm_scheduler.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(TM_SUSPEND_INTERFACE) || !defined(TM_STAT_INTERFACE)
+#error "tm_scheduler requires TM_SUSPEND_INTERFACE and TM_STAT_INTERFACE"
+#endif
+
+/**
+ * Iterative-deepening scheduler
+ *
+ * Every machine first runs for initial_budget steps. Undecided machines are suspended in compact form
+ * (tm_suspend()) and put at the back of a FIFO queue with their next slice multiplied by growth_factor,
+ * so all machines get their short slices before any machine gets a long one.
+ * When the head reaches the end of the tape, the tape is doubled (up to max_tape_length) with the visited cells
+ * re-centred and the slice goes on, so the tape length never decides a machine before max_tape_length.
+ * Once the entries and packed machines in memory would exceed memory_cap, new ones are spilled to spill_path
+ * as self-describing records, so spilled machines take no memory at all. Queued machines in memory are always
+ * older than the spilled ones, so the spill file is a FIFO too: it is read from spill_head and appended at spill_end,
+ * and the live records are moved to the front once the consumed prefix is larger than they are.
+*/
+
+/**
+ * Spill file record header, followed by size bytes of packed machine
+*/
+typedef struct {
+    unsigned int job_id;
+    tm_stat_step_numeric_t budget;
+    size_t size;
+} tm_scheduler_record_t;
+
+void tm_scheduler_init(tm_scheduler_t* scheduler, tm_stat_step_numeric_t initial_budget, unsigned int growth_factor, tm_stat_step_numeric_t max_budget, tm_tape_numeric_t max_tape_length, size_t memory_cap, char* spill_path) {
+    scheduler->queue_head = NULL;
+    scheduler->queue_tail = NULL;
+    scheduler->num_queued = 0;
+    scheduler->initial_budget = initial_budget > 0 ? initial_budget : 1;
+    scheduler->growth_factor = growth_factor > 1 ? growth_factor : 2;
+    scheduler->max_budget = max_budget;
+    scheduler->max_tape_length = max_tape_length;
+    scheduler->memory_used = 0;
+    scheduler->memory_cap = memory_cap;
+    scheduler->spill_path = spill_path;
+    scheduler->spill_file = NULL;
+    scheduler->spill_head = 0;
+    scheduler->spill_end = 0;
+    scheduler->num_spilled = 0;
+    scheduler->scratch = NULL;
+    scheduler->scratch_size = 0;
+    tm_arena_init(&scheduler->arena, TM_ARENA_DEFAULT_BLOCK_SIZE);
+}
+
+static unsigned char* tm_scheduler_scratch(tm_scheduler_t* scheduler, size_t size) {
+    if (size > scheduler->scratch_size) {
+        unsigned char* scratch = realloc(scheduler->scratch, size);
+        if (scratch == NULL) {
+            tm_error("Could not allocate scheduler scratch buffer\n");
+        }
+        scheduler->scratch = scratch;
+        scheduler->scratch_size = size;
+    }
+    return scheduler->scratch;
+}
+
+static void tm_scheduler_spill(tm_scheduler_t* scheduler, turing_machine_t* tm, turing_machine_stat_t* tm_stat, unsigned int job_id, tm_stat_step_numeric_t budget) {
+    if (scheduler->spill_file == NULL) {
+        scheduler->spill_file = fopen(scheduler->spill_path, "w+b");
+        if (scheduler->spill_file == NULL) {
+            tm_error("Could not open scheduler spill file\n");
+        }
+    }
+    tm_scheduler_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.job_id = job_id;
+    record.budget = budget;
+    record.size = tm_suspend_size(tm, tm_stat);
+
+    size_t record_size = sizeof(record) + record.size;
+    unsigned char* packed = tm_scheduler_scratch(scheduler, record_size);
+    memcpy(packed, &record, sizeof(record));
+    tm_suspend(tm, tm_stat, packed + sizeof(record));
+    if (fseek(scheduler->spill_file, scheduler->spill_end, SEEK_SET) != 0 || fwrite(packed, 1, record_size, scheduler->spill_file) != record_size) {
+        tm_error("Could not write to scheduler spill file\n");
+    }
+    scheduler->spill_end += (long)record_size;
+    scheduler->num_spilled++;
+}
+
+/**
+ * Moves the spilled records that have not been consumed yet to the front of the spill file
+*/
+static void tm_scheduler_compact(tm_scheduler_t* scheduler) {
+    long from = scheduler->spill_head;
+    long to = 0;
+    while (from < scheduler->spill_end) {
+        size_t chunk = (size_t)(scheduler->spill_end - from) < scheduler->scratch_size ? (size_t)(scheduler->spill_end - from) : scheduler->scratch_size;
+        if (fseek(scheduler->spill_file, from, SEEK_SET) != 0 || fread(scheduler->scratch, 1, chunk, scheduler->spill_file) != chunk) {
+            tm_error("Could not read from scheduler spill file\n");
+        }
+        if (fseek(scheduler->spill_file, to, SEEK_SET) != 0 || fwrite(scheduler->scratch, 1, chunk, scheduler->spill_file) != chunk) {
+            tm_error("Could not write to scheduler spill file\n");
+        }
+        from += (long)chunk;
+        to += (long)chunk;
+    }
+    scheduler->spill_end = to;
+    scheduler->spill_head = 0;
+}
+
+/**
+ * Suspends the machine and appends it to the queue
+*/
+static void tm_scheduler_enqueue(tm_scheduler_t* scheduler, turing_machine_t* tm, turing_machine_stat_t* tm_stat, unsigned int job_id, tm_stat_step_numeric_t budget) {
+    size_t size = tm_suspend_size(tm, tm_stat);
+    scheduler->num_queued++;
+
+    // Spill while older machines are spilled, so the queue stays in FIFO order
+    if (scheduler->num_spilled > 0 || scheduler->memory_used + sizeof(tm_scheduler_entry_t) + size > scheduler->memory_cap) {
+        tm_scheduler_spill(scheduler, tm, tm_stat, job_id, budget);
+        return;
+    }
+
+    tm_scheduler_entry_t* entry = malloc(sizeof(tm_scheduler_entry_t) + size);
+    if (entry == NULL) {
+        tm_error("Could not allocate suspended machine\n");
+    }
+    entry->job_id = job_id;
+    entry->budget = budget;
+    entry->size = size;
+    entry->blob = (unsigned char*)(entry + 1);
+    entry->next = NULL;
+    tm_suspend(tm, tm_stat, entry->blob);
+    scheduler->memory_used += sizeof(tm_scheduler_entry_t) + size;
+
+    if (scheduler->queue_tail == NULL) {
+        scheduler->queue_head = entry;
+    }
+    else {
+        scheduler->queue_tail->next = entry;
+    }
+    scheduler->queue_tail = entry;
+}
+
+/**
+ * Pops the front of the queue and resumes it into tm and tm_stat
+*/
+static void tm_scheduler_dequeue(tm_scheduler_t* scheduler, turing_machine_t* tm, turing_machine_stat_t* tm_stat, unsigned int* job_id, tm_stat_step_numeric_t* budget) {
+    scheduler->num_queued--;
+
+    tm_scheduler_entry_t* entry = scheduler->queue_head;
+    if (entry != NULL) {
+        scheduler->queue_head = entry->next;
+        if (scheduler->queue_head == NULL) {
+            scheduler->queue_tail = NULL;
+        }
+        *job_id = entry->job_id;
+        *budget = entry->budget;
+        tm_resume(tm, tm_stat, &scheduler->arena, entry->blob, 0);
+        scheduler->memory_used -= sizeof(tm_scheduler_entry_t) + entry->size;
+        free(entry);
+        return;
+    }
+
+    tm_scheduler_record_t record;
+    if (fseek(scheduler->spill_file, scheduler->spill_head, SEEK_SET) != 0 || fread(&record, sizeof(record), 1, scheduler->spill_file) != 1) {
+        tm_error("Could not read from scheduler spill file\n");
+    }
+    unsigned char* packed = tm_scheduler_scratch(scheduler, record.size);
+    if (fread(packed, 1, record.size, scheduler->spill_file) != record.size) {
+        tm_error("Could not read from scheduler spill file\n");
+    }
+    *job_id = record.job_id;
+    *budget = record.budget;
+    tm_resume(tm, tm_stat, &scheduler->arena, packed, 0);
+
+    scheduler->spill_head += (long)(sizeof(record) + record.size);
+    if (--scheduler->num_spilled == 0) {
+        scheduler->spill_head = 0;
+        scheduler->spill_end = 0;
+    }
+    else if (scheduler->spill_head > scheduler->spill_end - scheduler->spill_head) {
+        tm_scheduler_compact(scheduler);
+    }
+}
+
+/**
+ * Moves the machine to a tape twice as long (at most max_tape_length) from the scheduler's arena, with the visited cells re-centred
+*/
+static void tm_scheduler_grow_tape(tm_scheduler_t* scheduler, turing_machine_t* tm, turing_machine_stat_t* tm_stat) {
+    unsigned long long tape_length = 2ULL * tm->tape_length;
+    if (tape_length > scheduler->max_tape_length) {
+        tape_length = scheduler->max_tape_length;
+    }
+    unsigned char* packed = tm_scheduler_scratch(scheduler, tm_suspend_size(tm, tm_stat));
+    tm_suspend(tm, tm_stat, packed);
+    tm_resume(tm, tm_stat, &scheduler->arena, packed, (tm_tape_numeric_t)tape_length);
+}
+
+/**
+ * @param tm Initialized machine (tm_init() or tm_from_file()), copied into the queue
+*/
+void tm_scheduler_add(tm_scheduler_t* scheduler, turing_machine_t* tm, unsigned int job_id) {
+    turing_machine_stat_t tm_stat;
+    tm_arena_reset(&scheduler->arena);
+    tm_stat_alloc(&tm_stat, &scheduler->arena, tm);
+    tm_stat_init(&tm_stat, tm);
+    tm_scheduler_enqueue(scheduler, tm, &tm_stat, job_id, scheduler->initial_budget);
+}
+
+/**
+ * Runs until every queued machine has been reported to on_result
+*/
+void tm_scheduler_run(tm_scheduler_t* scheduler, tm_scheduler_result_fn on_result, void* user) {
+    turing_machine_t tm;
+    turing_machine_stat_t tm_stat;
+
+    while (scheduler->num_queued > 0) {
+        unsigned int job_id;
+        tm_stat_step_numeric_t slice;
+        tm_arena_reset(&scheduler->arena);
+        tm_scheduler_dequeue(scheduler, &tm, &tm_stat, &job_id, &slice);
+        tm_stat_step_numeric_t remaining = scheduler->max_budget - tm_stat.num_steps;
+        tm_stat_step_numeric_t budget = slice < remaining ? slice : remaining;
+        tm_stat_step_numeric_t slice_start = tm_stat.num_steps;
+        tm_run_result_t result = tm_run(&tm, &tm_stat, budget);
+        while (result == TM_RUN_TAPE_BOUNDARY && tm.tape_length < scheduler->max_tape_length) {
+            tm_scheduler_grow_tape(scheduler, &tm, &tm_stat);
+            result = tm_run(&tm, &tm_stat, budget - (tm_stat.num_steps - slice_start));
+        }
+
+        if (result != TM_RUN_BUDGET_EXHAUSTED || tm_stat.num_steps >= scheduler->max_budget) {
+            on_result(user, job_id, &tm, &tm_stat, result);
+        }
+        else {
+            unsigned long long next_budget = (unsigned long long)slice * scheduler->growth_factor;
+            if (next_budget > scheduler->max_budget) {
+                next_budget = scheduler->max_budget;
+            }
+            tm_scheduler_enqueue(scheduler, &tm, &tm_stat, job_id, (tm_stat_step_numeric_t)next_budget);
+        }
+    }
+}
+
+void tm_scheduler_free(tm_scheduler_t* scheduler) {
+    while (scheduler->queue_head != NULL) {
+        tm_scheduler_entry_t* entry = scheduler->queue_head;
+        scheduler->queue_head = entry->next;
+        free(entry);
+    }
+    scheduler->queue_tail = NULL;
+    scheduler->num_queued = 0;
+    scheduler->memory_used = 0;
+    if (scheduler->spill_file != NULL) {
+        fclose(scheduler->spill_file);
+        remove(scheduler->spill_path);
+        scheduler->spill_file = NULL;
+    }
+    scheduler->spill_head = 0;
+    scheduler->spill_end = 0;
+    scheduler->num_spilled = 0;
+    free(scheduler->scratch);
+    scheduler->scratch = NULL;
+    scheduler->scratch_size = 0;
+    tm_arena_free(&scheduler->arena);
+}
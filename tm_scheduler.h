@@ -0,0 +1,58 @@
+#include "turing.h"
+#include <stdio.h>
+
+#define TM_SCHEDULER_DEFAULT_INITIAL_BUDGET 256U
+#define TM_SCHEDULER_DEFAULT_GROWTH_FACTOR 4U
+#define TM_SCHEDULER_DEFAULT_MAX_BUDGET 4000000000U
+#define TM_SCHEDULER_DEFAULT_MAX_TAPE_LENGTH (256U * 1024U * 1024U)
+#define TM_SCHEDULER_DEFAULT_MEMORY_CAP (64U * 1024U * 1024U)
+#define TM_SCHEDULER_DEFAULT_SPILL_PATH "tm_scheduler.spill"
+
+/**
+ * Suspended machine waiting for its next slice, kept in memory.
+ * The packed machine (see tm_suspend()) follows the entry in the same allocation.
+ * Spilled machines have no entry, their job_id, budget and size are stored in the spill file.
+*/
+typedef struct tm_scheduler_entry {
+    unsigned int job_id;
+    tm_stat_step_numeric_t budget;
+    size_t size;
+    unsigned char* blob;
+    struct tm_scheduler_entry* next;
+} tm_scheduler_entry_t;
+
+/**
+ * Called once per machine, as soon as it halts, hits the boundary of a max_tape_length tape or exhausts max_budget (TM_RUN_BUDGET_EXHAUSTED)
+*/
+typedef void (*tm_scheduler_result_fn)(void* user, unsigned int job_id, turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_run_result_t result);
+
+typedef struct {
+    tm_scheduler_entry_t* queue_head;
+    tm_scheduler_entry_t* queue_tail;
+    size_t num_queued;
+
+    tm_stat_step_numeric_t initial_budget;
+    unsigned int growth_factor;
+    tm_stat_step_numeric_t max_budget;
+    tm_tape_numeric_t max_tape_length; // tapes are doubled up to this length when the head reaches their end
+
+    size_t memory_used; // entries and their packed machines
+    size_t memory_cap;
+    char* spill_path;
+    FILE* spill_file;
+    long spill_head; // offset of the oldest spilled record
+    long spill_end;
+    size_t num_spilled;
+
+    unsigned char* scratch;
+    size_t scratch_size;
+    tm_arena_t arena; // storage of the machine being run, reset for every slice
+} tm_scheduler_t;
+
+void tm_scheduler_init(tm_scheduler_t* scheduler, tm_stat_step_numeric_t initial_budget, unsigned int growth_factor, tm_stat_step_numeric_t max_budget, tm_tape_numeric_t max_tape_length, size_t memory_cap, char* spill_path);
+
+void tm_scheduler_add(tm_scheduler_t* scheduler, turing_machine_t* tm, unsigned int job_id);
+
+void tm_scheduler_run(tm_scheduler_t* scheduler, tm_scheduler_result_fn on_result, void* user);
+
+void tm_scheduler_free(tm_scheduler_t* scheduler);
@@ -0,0 +1,100 @@
+/**
+ * Sweep driver for the iterative-deepening scheduler
+ *
+ * Compile & run:
+ *  cmake --build ./build --config Release --target tm_sweep --
+ *  cd ./build
+ *  ./tm_sweep ../tms/bb2.tm ../tms/bb3.tm ../tms/bb4.tm ../tms/bb5c.tm ../tms/bb6c.tm
+ *
+ * Options:
+ *  -b <steps>  first slice (default TM_SCHEDULER_DEFAULT_INITIAL_BUDGET)
+ *  -g <factor> slice growth factor (default TM_SCHEDULER_DEFAULT_GROWTH_FACTOR)
+ *  -m <steps>  total step budget per machine (default TM_SCHEDULER_DEFAULT_MAX_BUDGET)
+ *  -M <kB>     memory cap for suspended machines (default TM_SCHEDULER_DEFAULT_MEMORY_CAP)
+ *  -f <path>   spill file (default TM_SCHEDULER_DEFAULT_SPILL_PATH)
+ *  -t <cells>  initial tape length (default TM_DEFAULT_TAPE_LENGTH)
+ *  -T <cells>  tape length up to which tapes are doubled when the head reaches their end (default TM_SCHEDULER_DEFAULT_MAX_TAPE_LENGTH)
+ */
+
+#include "tm_scheduler.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void tm_sweep_report(void* user, unsigned int job_id, turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_run_result_t result) {
+    char** paths = (char**)user;
+    unsigned long ones = 0;
+    for (tm_tape_numeric_t i = tm_stat->min_head; i <= tm_stat->max_head; i++) {
+        ones += tm->tape[i] != TM_BLANK_SYMBOL;
+    }
+    switch (result) {
+        case TM_RUN_HALTED:
+            printf("%s: halted after %u steps, %lu non-blank cells\n", paths[job_id], tm_stat->num_steps, ones);
+            break;
+        case TM_RUN_TAPE_BOUNDARY:
+            printf("%s: head left the %u-cell tape after %u steps\n", paths[job_id], tm->tape_length, tm_stat->num_steps);
+            break;
+        default:
+            printf("%s: undecided after %u steps\n", paths[job_id], tm_stat->num_steps);
+            break;
+    }
+}
+
+int main(int argc, char** argv) {
+    tm_stat_step_numeric_t initial_budget = TM_SCHEDULER_DEFAULT_INITIAL_BUDGET;
+    unsigned int growth_factor = TM_SCHEDULER_DEFAULT_GROWTH_FACTOR;
+    tm_stat_step_numeric_t max_budget = TM_SCHEDULER_DEFAULT_MAX_BUDGET;
+    size_t memory_cap = TM_SCHEDULER_DEFAULT_MEMORY_CAP;
+    char* spill_path = TM_SCHEDULER_DEFAULT_SPILL_PATH;
+    tm_tape_numeric_t tape_length = TM_DEFAULT_TAPE_LENGTH;
+    tm_tape_numeric_t max_tape_length = TM_SCHEDULER_DEFAULT_MAX_TAPE_LENGTH;
+
+    int i = 1;
+    for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (strcmp(argv[i], "-b") == 0) {
+            initial_budget = (tm_stat_step_numeric_t)strtoul(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-g") == 0) {
+            growth_factor = (unsigned int)strtoul(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-m") == 0) {
+            max_budget = (tm_stat_step_numeric_t)strtoul(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-M") == 0) {
+            memory_cap = (size_t)strtoul(argv[i + 1], NULL, 10) * 1024U;
+        }
+        else if (strcmp(argv[i], "-f") == 0) {
+            spill_path = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "-t") == 0) {
+            tape_length = (tm_tape_numeric_t)strtoul(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-T") == 0) {
+            max_tape_length = (tm_tape_numeric_t)strtoul(argv[i + 1], NULL, 10);
+        }
+        else {
+            break;
+        }
+    }
+    if (i >= argc || argv[i][0] == '-') {
+        fprintf(stderr, "Usage: %s [-b steps] [-g factor] [-m steps] [-M kB] [-f spill] [-t cells] [-T cells] file.tm ...\n", argv[0]);
+        return 2;
+    }
+
+    tm_scheduler_t scheduler;
+    tm_scheduler_init(&scheduler, initial_budget, growth_factor, max_budget, max_tape_length, memory_cap, spill_path);
+
+    turing_machine_t tm;
+    tm_arena_t arena;
+    tm_arena_init(&arena, TM_ARENA_DEFAULT_BLOCK_SIZE);
+    char** paths = argv + i;
+    for (unsigned int job_id = 0; job_id < (unsigned int)(argc - i); job_id++) {
+        tm_arena_reset(&arena);
+        tm_from_file(&tm, &arena, paths[job_id], tape_length);
+        tm_scheduler_add(&scheduler, &tm, job_id);
+    }
+    tm_arena_free(&arena);
+
+    tm_scheduler_run(&scheduler, tm_sweep_report, paths);
+    tm_scheduler_free(&scheduler);
+    return 0;
+}
@@ -6,20 +6,88 @@
 
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
 
-void tm_init_tape(turing_machine_t* tm) {
-    for (tm_tape_numeric_t i = 0; i < TM_TAPE_LENGTH; i++) {
-        tm->tape[i] = TM_BLANK_SYMBOL;
+void tm_arena_init(tm_arena_t* arena, size_t block_size) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->block_size = block_size > 0 ? block_size : TM_ARENA_DEFAULT_BLOCK_SIZE;
+}
+
+/**
+ * @returns Zero-filled memory aligned to TM_ARENA_ALIGNMENT, valid until the next tm_arena_reset() or tm_arena_free()
+*/
+void* tm_arena_alloc(tm_arena_t* arena, size_t size) {
+    while (arena->current != NULL) {
+        tm_arena_block_t* block = arena->current;
+        uintptr_t start = ((uintptr_t)(block->data + block->used) + TM_ARENA_ALIGNMENT - 1) & ~(uintptr_t)(TM_ARENA_ALIGNMENT - 1);
+        size_t offset = start - (uintptr_t)block->data;
+        if (offset + size <= block->size) {
+            block->used = offset + size;
+            memset((void*)start, 0, size);
+            return (void*)start;
+        }
+        // Blocks kept from before a reset are reused before new ones are allocated
+        if (block->next == NULL) {
+            break;
+        }
+        arena->current = block->next;
+    }
+
+    size_t block_size = size + TM_ARENA_ALIGNMENT > arena->block_size ? size + TM_ARENA_ALIGNMENT : arena->block_size;
+    tm_arena_block_t* block = malloc(sizeof(tm_arena_block_t) + block_size);
+    if (block == NULL) {
+        tm_error("Could not allocate arena block\n");
     }
+    block->next = NULL;
+    block->size = block_size;
+    block->used = 0;
+    block->data = (unsigned char*)(block + 1);
+    if (arena->current == NULL) {
+        arena->first = block;
+    }
+    else {
+        arena->current->next = block;
+    }
+    arena->current = block;
+    return tm_arena_alloc(arena, size);
 }
 
 /**
- * @note Doesn't initialize transition bundles, it needs to be done separately
+ * Invalidates all allocations and keeps the blocks for reuse
 */
-void tm_init(turing_machine_t* tm, tm_state_t num_states, tm_symbol_t num_symbols) {
-    tm_init_tape(tm);
-    tm->head = TM_INIT_HEAD;
-    tm->state = TM_INIT_STATE;
+void tm_arena_reset(tm_arena_t* arena) {
+    for (tm_arena_block_t* block = arena->first; block != NULL; block = block->next) {
+        block->used = 0;
+    }
+    arena->current = arena->first;
+}
+
+void tm_arena_free(tm_arena_t* arena) {
+    tm_arena_block_t* block = arena->first;
+    while (block != NULL) {
+        tm_arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+/**
+ * Allocates the tape and num_states x num_symbols transitions from the arena and sets the machine dimensions
+ * @note Doesn't initialize transition bundles nor the tape, call tm_init() afterwards
+*/
+void tm_alloc(turing_machine_t* tm, tm_arena_t* arena, tm_state_t num_states, tm_symbol_t num_symbols, tm_tape_numeric_t tape_length) {
+    tm->tape = tm_arena_alloc(arena, (size_t)tape_length * sizeof(tm_symbol_t));
+    tm->tape_length = tape_length;
+    tm->transition_bundles = tm_arena_alloc(arena, (size_t)num_states * sizeof(tm_transition_bundle_t));
+    tm_state_transition_t* transitions = tm_arena_alloc(arena, (size_t)num_states * num_symbols * sizeof(tm_state_transition_t));
+    for (tm_state_t i = 0; i < num_states; i++) {
+        tm->transition_bundles[i].transitions = transitions + (size_t)i * num_symbols;
+        tm->transition_bundles[i].bundle_size = num_symbols;
+    }
     tm->num_states = num_states;
     tm->num_symbols = num_symbols;
     #ifdef TM_GUARDS
@@ -27,6 +95,22 @@ void tm_init(turing_machine_t* tm, tm_state_t num_states, tm_symbol_t num_symbol
     #endif
 }
 
+void tm_init_tape(turing_machine_t* tm) {
+    for (tm_tape_numeric_t i = 0; i < tm->tape_length; i++) {
+        tm->tape[i] = TM_BLANK_SYMBOL;
+    }
+}
+
+/**
+ * Clears the tape and puts the head in the middle of it, in the initial state
+ * @note Doesn't initialize transition bundles, it needs to be done separately
+*/
+void tm_init(turing_machine_t* tm) {
+    tm_init_tape(tm);
+    tm->head = tm->tape_length / 2;
+    tm->state = TM_INIT_STATE;
+}
+
 void tm_error(char* message) {
     #ifdef TM_STDERR_OUTPUT
     fprintf(stderr, message);
@@ -83,17 +167,17 @@ void tm_fprintf(FILE* stream, char* format, ...) {
 }
 void tm_fdump_config(FILE* stream, turing_machine_t* tm) {
     tm_fprintf(stream, "Turing machine configuration:\n");
-    tm_fprintf(stream, "Number of states: %hhu\n", tm->num_states);
-    tm_fprintf(stream, "Number of symbols: %hhu\n", tm->num_symbols);
+    tm_fprintf(stream, "Number of states: %u\n", tm->num_states);
+    tm_fprintf(stream, "Number of symbols: %u\n", tm->num_symbols);
     tm_fprintf(stream, "Head position: %u\n", tm->head);
-    tm_fprintf(stream, "State: %hhu\n", tm->state);
+    tm_fprintf(stream, "State: %u\n", tm->state);
     tm_fprintf(stream, "Transition bundles:\n");
     for (tm_state_t i = 0; i < tm->num_states; i++) {
-        tm_fprintf(stream, "State %hhu:\n", i);
+        tm_fprintf(stream, "State %u:\n", i);
         tm_transition_bundle_t* tb = &tm->transition_bundles[i];
         for (tm_symbol_t j = 0; j < tb->bundle_size; j++) {
             tm_state_transition_t* t = &tb->transitions[j];
-            tm_fprintf(stream, "  Read symbol %hhu: write symbol %hhu, head direction %hhu, next state %hhu\n", t->read_symbol, t->write_symbol, t->head_direction, t->state);
+            tm_fprintf(stream, "  Read symbol %u: write symbol %u, head direction %u, next state %u\n", t->read_symbol, t->write_symbol, t->head_direction, t->state);
         }
     }
     tm_printf("\n");
@@ -105,33 +189,33 @@ turing_machine_validation_result_t tm_validate_machine(turing_machine_t* tm) {
     for (tm_state_t i = 0; i < tm->num_states; i++) {
         tm_transition_bundle_t* tb = &tm->transition_bundles[i];
         if (tb == 0) { 
-            tm_errorf("Transition bundle for state %hhu is null", i);
+            tm_errorf("Transition bundle for state %u is null", i);
             return TM_VALIDATION_FAILURE; 
         }
         if (tb->bundle_size <= 0) {
-            tm_errorf("Transition bundle for state %hhu has bundle size %hhu, which is less than or equal to 0", i, tb->bundle_size);
+            tm_errorf("Transition bundle for state %u has bundle size %u, which is less than or equal to 0", i, tb->bundle_size);
             return TM_VALIDATION_FAILURE;
         }
         if (tb->bundle_size != tm->num_symbols) { 
-            tm_errorf("Transition bundle for state %hhu has bundle size %hhu, which is different than the number of symbols %hhu. Required to be the same", i, tb->bundle_size, tm->num_symbols);
+            tm_errorf("Transition bundle for state %u has bundle size %u, which is different than the number of symbols %u. Required to be the same", i, tb->bundle_size, tm->num_symbols);
             return TM_VALIDATION_FAILURE;
         }
         for (tm_symbol_t j = 0; j < tb->bundle_size; j++) {
             tm_state_transition_t* t = &tb->transitions[j];
             if (t->read_symbol != j) {
-                tm_errorf("Transition bundle for state %hhu has transition with read symbol %hhu, which is not equal to the expected read symbol %hhu", i, t->read_symbol, j);
+                tm_errorf("Transition bundle for state %u has transition with read symbol %u, which is not equal to the expected read symbol %u", i, t->read_symbol, j);
                 return TM_VALIDATION_FAILURE; 
             }
             if (t->write_symbol < 0 || t->write_symbol >= tm->num_symbols) { 
-                tm_errorf("Transition bundle for state %hhu has transition with read symbol %hhu and write symbol %hhu, which is not in the range [0, %hhu)", i, t->read_symbol, t->write_symbol, tm->num_symbols);
+                tm_errorf("Transition bundle for state %u has transition with read symbol %u and write symbol %u, which is not in the range [0, %u)", i, t->read_symbol, t->write_symbol, tm->num_symbols);
                 return TM_VALIDATION_FAILURE;
             }
             if (t->head_direction != TM_HEAD_LEFT && t->head_direction != TM_HEAD_RIGHT) {
-                tm_errorf("Transition bundle for state %hhu has transition with read symbol %hhu and head direction %hhu, which is not TM_HEAD_LEFT or TM_HEAD_RIGHT", i, t->read_symbol, t->head_direction);
+                tm_errorf("Transition bundle for state %u has transition with read symbol %u and head direction %u, which is not TM_HEAD_LEFT or TM_HEAD_RIGHT", i, t->read_symbol, t->head_direction);
                 return TM_VALIDATION_FAILURE;
             }
             if ((t->state < 0 || t->state >= tm->num_states) && t->state != TM_HALT_STATE) { 
-                tm_errorf("Transition bundle for state %hhu has transition with read symbol %hhu and next state %hhu, which is not in the range [0, %hhu) or equal to TM_HALT_STATE", i, t->read_symbol, t->state, tm->num_states);
+                tm_errorf("Transition bundle for state %u has transition with read symbol %u and next state %u, which is not in the range [0, %u) or equal to TM_HALT_STATE", i, t->read_symbol, t->state, tm->num_states);
                 return TM_VALIDATION_FAILURE;
             }
             if (t->state == TM_HALT_STATE) {
@@ -173,9 +257,7 @@ void tm_make_transition(turing_machine_t* tm) {
         tm_error("Turing machine is already in halt state\n");
     }
     tm_state_transition_t* t = tm_get_transition(tm);
-    tm_debugf("Read symbol %hhu, write symbol %hhu, head direction %hhu, next state %hhu, tape pos %u, state: %hhu\n", t->read_symbol, t->write_symbol, t->head_direction, t->state, tm->head, tm->state);
-
-    tm->tape[tm->head] = t->write_symbol;
+    tm_debugf("Read symbol %u, write symbol %u, head direction %u, next state %u, tape pos %u, state: %u\n", t->read_symbol, t->write_symbol, t->head_direction, t->state, tm->head, tm->state);
 
     #ifdef TM_STAT_INTERFACE
     tm_stat->reads[tm->tape[tm->head]]++;
@@ -183,6 +265,8 @@ void tm_make_transition(turing_machine_t* tm) {
     tm_stat->state_visits[tm->state]++;
     #endif
 
+    tm->tape[tm->head] = t->write_symbol;
+
     if (t->head_direction == TM_HEAD_LEFT) {
         if (tm->head == 0x0) {
             tm_error("Turing machine head out of range");
@@ -190,7 +274,7 @@ void tm_make_transition(turing_machine_t* tm) {
         tm->head--;
     }
     else {
-        if (tm->head == TM_TAPE_LENGTH - 1) {
+        if (tm->head == tm->tape_length - 1) {
             tm_error("Turing machine head out of range");
         }
         tm->head++;
@@ -210,17 +294,106 @@ void tm_make_transition(turing_machine_t* tm) {
 }
 
 
+/**
+ * Batched alternative to calling tm_make_transition() in a loop.
+ * Runs at most max_steps transitions with head, state and stat counters kept in locals.
+ * Unlike tm_make_transition(), it doesn't exit when the head would leave the tape;
+ * it stops before that transition and returns TM_RUN_TAPE_BOUNDARY instead.
+ * 
+ * @returns TM_RUN_HALTED if the machine is in halt state on return, TM_RUN_TAPE_BOUNDARY if the next transition would move the head out of range, TM_RUN_BUDGET_EXHAUSTED otherwise
+*/
 #ifdef TM_STAT_INTERFACE
-void tm_stat_init(turing_machine_stat_t* tm_stat, tm_symbol_t tm_num_symbols, tm_state_t tm_num_states) {
-    tm_stat->min_head = TM_INIT_HEAD;
-    tm_stat->max_head = TM_INIT_HEAD;
+tm_run_result_t tm_run(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_stat_step_numeric_t max_steps) {
+#else
+tm_run_result_t tm_run(turing_machine_t* tm, tm_stat_step_numeric_t max_steps) {
+#endif
+    tm_symbol_t* tape = tm->tape;
+    tm_tape_numeric_t head = tm->head;
+    tm_state_t state = tm->state;
+    tm_run_result_t result = TM_RUN_BUDGET_EXHAUSTED;
+    tm_stat_step_numeric_t num_steps = 0;
+
+    #ifdef TM_STAT_INTERFACE
+    tm_tape_numeric_t min_head = tm_stat->min_head;
+    tm_tape_numeric_t max_head = tm_stat->max_head;
+    #endif
+
+    for (; num_steps < max_steps; num_steps++) {
+        if (state == TM_HALT_STATE) {
+            break;
+        }
+        const tm_state_transition_t* t = &tm->transition_bundles[state].transitions[tape[head]];
+        if (t->head_direction == TM_HEAD_LEFT ? head == 0x0 : head == tm->tape_length - 1) {
+            result = TM_RUN_TAPE_BOUNDARY;
+            break;
+        }
+
+        #ifdef TM_STAT_INTERFACE
+        tm_stat->reads[tape[head]]++;
+        tm_stat->writes[t->write_symbol]++;
+        tm_stat->state_visits[state]++;
+        #endif
+
+        tape[head] = t->write_symbol;
+        if (t->head_direction == TM_HEAD_LEFT) {
+            head--;
+        }
+        else {
+            head++;
+        }
+
+        #ifdef TM_STAT_INTERFACE
+        if (head < min_head) {
+            min_head = head;
+        }
+        else if (head > max_head) {
+            max_head = head;
+        }
+        #endif
+
+        state = t->state;
+    }
+
+    tm->head = head;
+    tm->state = state;
+    #ifdef TM_STAT_INTERFACE
+    tm_stat->min_head = min_head;
+    tm_stat->max_head = max_head;
+    tm_stat->num_steps += num_steps;
+    #endif
+
+    if (state == TM_HALT_STATE) {
+        return TM_RUN_HALTED;
+    }
+    return result;
+}
+
+
+#ifdef TM_STAT_INTERFACE
+/**
+ * Allocates counters for the dimensions of tm from the arena
+ * @note Doesn't initialize the counters, call tm_stat_init() afterwards
+*/
+void tm_stat_alloc(turing_machine_stat_t* tm_stat, tm_arena_t* arena, turing_machine_t* tm) {
+    tm_stat->reads = tm_arena_alloc(arena, (size_t)tm->num_symbols * sizeof(tm_stat_read_numeric_t));
+    tm_stat->writes = tm_arena_alloc(arena, (size_t)tm->num_symbols * sizeof(tm_stat_write_numeric_t));
+    tm_stat->state_visits = tm_arena_alloc(arena, (size_t)tm->num_states * sizeof(tm_stat_step_numeric_t));
+    tm_stat->tm_num_symbols = tm->num_symbols;
+    tm_stat->tm_num_states = tm->num_states;
+}
+
+/**
+ * Resets the counters, the visited range starts at the current head position of tm
+*/
+void tm_stat_init(turing_machine_stat_t* tm_stat, turing_machine_t* tm) {
+    tm_stat->min_head = tm->head;
+    tm_stat->max_head = tm->head;
     tm_stat->num_steps = 0;
-    tm_stat->tm_num_symbols = tm_num_symbols;
-    for (tm_symbol_t i = 0; i < tm_num_symbols; i++) {
+    for (tm_symbol_t i = 0; i < tm_stat->tm_num_symbols; i++) {
         tm_stat->reads[i] = 0;
         tm_stat->writes[i] = 0;
     }
-    for (tm_state_t i = 0; i < tm_num_states; i++) {
+    for (tm_state_t i = 0; i < tm_stat->tm_num_states; i++) {
         tm_stat->state_visits[i] = 0;
     }
 }
@@ -228,71 +401,129 @@ void tm_stat_init(turing_machine_stat_t* tm_stat, tm_symbol_t tm_num_symbols, tm
 
 #ifdef TM_FILE_INTERFACE
 
-tm_state_t tm_resolve_state_name(char state_name, char* state_names, char halt_state_name, tm_state_t num_states) {
+#define TM_NAME_SIZE (TM_MAX_NAME_LENGTH + 1)
+#define TM_STRINGIFY_(x) #x
+#define TM_STRINGIFY(x) TM_STRINGIFY_(x)
+#define TM_NAME_SCANF " %" TM_STRINGIFY(TM_MAX_NAME_LENGTH) "s"
+#define TM_MAX_TUPLE_LENGTH 191 // 3 names of TM_MAX_NAME_LENGTH and 2 commas
+#define TM_TUPLE_SCANF " %" TM_STRINGIFY(TM_MAX_TUPLE_LENGTH) "s"
+
+#if TM_MAX_TUPLE_LENGTH != 3 * TM_MAX_NAME_LENGTH + 2
+#error "TM_MAX_TUPLE_LENGTH must be 3 * TM_MAX_NAME_LENGTH + 2"
+#endif
+
+/**
+ * fscanf() splits words that don't fit max_length silently, so a word filling the whole buffer is rejected
+*/
+static void tm_check_name_length(char* name, size_t max_length, char* what) {
+    if (strlen(name) >= max_length) {
+        tm_errorf("%s starting with %.16s... is too long, names must be shorter than %u characters\n", what, name, (unsigned int)TM_MAX_NAME_LENGTH);
+    }
+}
+
+tm_state_t tm_resolve_state_name(char* state_name, char* state_names, char* halt_state_name, tm_state_t num_states) {
     for (tm_state_t i = 0; i < num_states; i++) {
-        if (state_names[i] == state_name) {
+        if (strcmp(state_names + (size_t)i * TM_NAME_SIZE, state_name) == 0) {
             return i;
         }
     }
-    if (state_name == halt_state_name) {
+    if (strcmp(state_name, halt_state_name) == 0) {
         return TM_HALT_STATE;
     }
-    tm_errorf("Could not resolve state name %c", state_name);
+    tm_errorf("Could not resolve state name %s", state_name);
     return 0;
 }
 
-tm_symbol_t tm_resolve_symbol_name(char symbol_name, char* symbol_names, tm_symbol_t num_symbols) {
+tm_symbol_t tm_resolve_symbol_name(char* symbol_name, char* symbol_names, tm_symbol_t num_symbols) {
     for (tm_symbol_t i = 0; i < num_symbols; i++) {
-        if (symbol_names[i] == symbol_name) {
+        if (strcmp(symbol_names + (size_t)i * TM_NAME_SIZE, symbol_name) == 0) {
             return i;
         }
     }
-    tm_errorf("Could not resolve symbol name %c", symbol_name);
+    tm_errorf("Could not resolve symbol name %s", symbol_name);
     return 0;
 }
 
-tm_head_dir_t tm_resolve_head_direction_name(char head_direction_name, char* head_direction_names) {
-    if (!head_direction_name) {
+tm_head_dir_t tm_resolve_head_direction_name(char* head_direction_name, char* head_left_name, char* head_right_name) {
+    if (!head_direction_name || !head_direction_name[0]) {
         tm_error("Null reference values for head direction names");
     }
 
-    if (head_direction_name == head_direction_names[0]) {
+    if (strcmp(head_direction_name, head_left_name) == 0) {
         return TM_HEAD_LEFT;
     }
-    else if (head_direction_name == head_direction_names[1]) {
+    else if (strcmp(head_direction_name, head_right_name) == 0) {
         return TM_HEAD_RIGHT;
     }
-    tm_errorf("Could not resolve head direction name %c", head_direction_name);
+    tm_errorf("Could not resolve head direction name %s", head_direction_name);
     return 0;
 }
 
+/**
+ * Splits a transition tuple into write symbol, head direction and next state names.
+ * The tuple is either 3 characters ("1RB") or 3 comma-separated names ("1,R,q12").
+ * @note Modifies tuple
+*/
+void tm_split_transition_tuple(char* tuple, char* names[3]) {
+    static char single[3][2];
+    if (strchr(tuple, ',') == NULL) {
+        if (strlen(tuple) != 3) {
+            tm_errorf("Transition tuple %s is neither 3 characters nor comma-separated", tuple);
+        }
+        for (int k = 0; k < 3; k++) {
+            single[k][0] = tuple[k];
+            single[k][1] = '\0';
+            names[k] = single[k];
+        }
+        return;
+    }
+    names[0] = tuple;
+    for (int k = 1; k < 3; k++) {
+        char* comma = strchr(names[k - 1], ',');
+        if (comma == NULL) {
+            tm_errorf("Transition tuple %s has less than 3 comma-separated names", tuple);
+        }
+        *comma = '\0';
+        names[k] = comma + 1;
+    }
+    if (strchr(names[2], ',') != NULL) {
+        tm_errorf("Transition tuple %s has more than 3 comma-separated names", tuple);
+    }
+}
+
 /**
  * *.tm file format specification:
  * 1st line: number of states (integer) and number of symbols (integer) space-separated
- * 2nd line: state name (single characters) space-separated
- * 3rd line: halt state name (single character)
- * 4th line: symbol names (single characters) space-separated
- * 5th line: head left name (single character) and head right name (single character) space-separated
+ * 2nd line: state names space-separated
+ * 3rd line: halt state name
+ * 4th line: symbol names space-separated
+ * 5th line: head left name and head right name space-separated
  * 6th line and onwards: transition table
+ * Names are up to TM_MAX_NAME_LENGTH non-whitespace characters
  * 
  * Transition table format:
  * Each line represents a collection of transitions
  * Transitions in the first line correspond to read symbol 0, transitions in the second line correspond to read symbol 1, etc.
  * Each line should contain a space-separated list of transition tuples
  * First transition tuple corresponds to current state 0, second transition tuple corresponds to current state 1, etc.
- * Each transition tuple is a string of 3 characters: write symbol, head direction, next state
+ * Each transition tuple is either a string of 3 characters: write symbol, head direction, next state (when these names are single characters)
+ * or the 3 names separated by commas, e.g. "1,R,q12"
  * 
- * @note This function initializes the turing machine - it calls tm_init() and initializes transition bundles
+ * @param tape_length Number of tape cells, TM_DEFAULT_TAPE_LENGTH unless the caller knows better; the head starts in the middle
+ * @note This function allocates the turing machine from the arena and initializes it - it calls tm_alloc(), tm_init() and initializes transition bundles
 */
-void tm_from_file(turing_machine_t* tm, char* path) {
-    char state_names[TM_MAX_STATES];
-    char halt_state_name;
-    char symbol_names[TM_MAX_SYMBOLS];
-    char head_left_name;
-    char head_right_name;
+void tm_from_file(turing_machine_t* tm, tm_arena_t* arena, char* path, tm_tape_numeric_t tape_length) {
+    char halt_state_name[TM_NAME_SIZE];
+    char head_left_name[TM_NAME_SIZE];
+    char head_right_name[TM_NAME_SIZE];
+    char tuple[TM_MAX_TUPLE_LENGTH + 1];
 
     tm_state_t num_states;
     tm_symbol_t num_symbols;
+
+    if (tape_length == 0) {
+        tm_error("Tape length must be at least 1\n");
+    }
     
     FILE* file = fopen(path, "r");
     if (file == NULL) {
@@ -300,66 +531,75 @@ void tm_from_file(turing_machine_t* tm, char* path) {
     }
 
     // Read number of states and symbols, example "3 2"
-    int num_states_int;
-    int num_symbols_int;
-    if (fscanf(file, "%d %d", &num_states_int, &num_symbols_int) != 2) {
+    long num_states_int;
+    long num_symbols_int;
+    if (fscanf(file, "%ld %ld", &num_states_int, &num_symbols_int) != 2) {
         tm_error("Could not read number of states and symbols from file");
     }
-    num_states = (tm_state_t)num_states_int;
-    num_symbols = (tm_symbol_t)num_symbols_int;
 
     // Validate number of states and symbols
-    if (num_states > TM_MAX_STATES || num_symbols > TM_MAX_SYMBOLS) {
-        tm_error("Number of states or symbols exceeds maximum");
+    if (num_states_int < 1 || num_symbols_int < 1) {
+        tm_errorf("Number of states and symbols must be at least 1, got %ld states and %ld symbols", num_states_int, num_symbols_int);
     }
-    if (num_states < 1 || num_symbols < 1) {
-        tm_errorf("Number of states and symbols must be at least 1, got %hhu states and %hhu symbols", num_states, num_symbols);
+    if (num_states_int >= TM_HALT_STATE || num_symbols_int >= TM_SYMBOL_LIMIT) {
+        tm_errorf("Number of states or symbols exceeds maximum (%u states, %u symbols), see TM_WIDE_STATES and TM_WIDE_SYMBOLS\n", TM_HALT_STATE - 1, TM_SYMBOL_LIMIT - 1);
+    }
+    num_states = (tm_state_t)num_states_int;
+    num_symbols = (tm_symbol_t)num_symbols_int;
+
+    char* state_names = malloc((size_t)num_states * TM_NAME_SIZE);
+    char* symbol_names = malloc((size_t)num_symbols * TM_NAME_SIZE);
+    if (state_names == NULL || symbol_names == NULL) {
+        tm_error("Could not allocate state and symbol names");
     }
     
     // Move state names, example "A B C"
     for (tm_state_t i = 0; i < num_states; i++) {
-        if (fscanf(file, " %c", &state_names[i]) != 1) {
+        if (fscanf(file, TM_NAME_SCANF, state_names + (size_t)i * TM_NAME_SIZE) != 1) {
             tm_error("Could not read state names from file");
         }
+        tm_check_name_length(state_names + (size_t)i * TM_NAME_SIZE, TM_MAX_NAME_LENGTH, "State name");
     }
 
     // Read halt state name, example "H"
-    if (fscanf(file, " %c", &halt_state_name) != 1) {
+    if (fscanf(file, TM_NAME_SCANF, halt_state_name) != 1) {
         tm_error("Could not read halt state name from file");
     }
+    tm_check_name_length(halt_state_name, TM_MAX_NAME_LENGTH, "Halt state name");
 
     // Read symbol names, example "0 1"
     for (tm_symbol_t i = 0; i < num_symbols; i++) {
-        if (fscanf(file, " %c", &symbol_names[i]) != 1) {
+        if (fscanf(file, TM_NAME_SCANF, symbol_names + (size_t)i * TM_NAME_SIZE) != 1) {
             tm_error("Could not read symbol names from file");
         }
+        tm_check_name_length(symbol_names + (size_t)i * TM_NAME_SIZE, TM_MAX_NAME_LENGTH, "Symbol name");
     }
 
     // Read head left and right names, example "L R"
-    if (fscanf(file, " %c %c", &head_left_name, &head_right_name) != 2) {
+    if (fscanf(file, TM_NAME_SCANF TM_NAME_SCANF, head_left_name, head_right_name) != 2) {
         tm_error("Could not read head left and right names from file");
     }
+    tm_check_name_length(head_left_name, TM_MAX_NAME_LENGTH, "Head left name");
+    tm_check_name_length(head_right_name, TM_MAX_NAME_LENGTH, "Head right name");
+
+    // Allocate the machine, bundle sizes are set by tm_alloc()
+    tm_alloc(tm, arena, num_states, num_symbols, tape_length);
 
-    // Initialize transition bundles
-    for (tm_state_t i = 0; i < num_states; i++) {
-        tm_transition_bundle_t* tb = &tm->transition_bundles[i];
-        tb->bundle_size = num_symbols;
-    }
     // Read transition table
     for (tm_symbol_t i = 0; i < num_symbols; i++) {
         for (tm_state_t j = 0; j < num_states; j++) {
             tm_state_transition_t* t = &tm->transition_bundles[j].transitions[i];
             
-            char write_symbol_name;
-            char head_direction_name;
-            char state_name;
-            if (fscanf(file, " %c%c%c", &write_symbol_name, &head_direction_name, &state_name) != 3) {
+            char* names[3];
+            if (fscanf(file, TM_TUPLE_SCANF, tuple) != 1) {
                 tm_error("Could not read transition table from file");
             }
+            tm_check_name_length(tuple, TM_MAX_TUPLE_LENGTH, "Transition");
+            tm_split_transition_tuple(tuple, names);
             t->read_symbol = i;
-            t->write_symbol = tm_resolve_symbol_name(write_symbol_name, symbol_names, num_symbols);
-            t->head_direction = tm_resolve_head_direction_name(head_direction_name, (char[]){head_left_name, head_right_name});
-            t->state = tm_resolve_state_name(state_name, state_names, halt_state_name, num_states);
+            t->write_symbol = tm_resolve_symbol_name(names[0], symbol_names, num_symbols);
+            t->head_direction = tm_resolve_head_direction_name(names[1], head_left_name, head_right_name);
+            t->state = tm_resolve_state_name(names[2], state_names, halt_state_name, num_states);
         }
     }
 
@@ -368,9 +608,11 @@ void tm_from_file(turing_machine_t* tm, char* path) {
     #endif
 
     fclose(file);
+    free(state_names);
+    free(symbol_names);
     
     // Fill the turing machine struct (transition bundles are already filled)
-    tm_init(tm, num_states, num_symbols);
+    tm_init(tm);
 
     tm_print("File TM data loaded\n");
     // Validate the turing machine
@@ -382,3 +624,147 @@ void tm_from_file(turing_machine_t* tm, char* path) {
     }
 }
 #endif
+
+#if defined(TM_SUSPEND_INTERFACE) && defined(TM_STAT_INTERFACE)
+
+/**
+ * Compact form of a live machine, followed in the buffer by:
+ * transitions (write symbol, head direction, next state - num_states * num_symbols each),
+ * reads and writes (num_symbols each), state visits (num_states)
+ * and the visited tape cells [min_head, max_head]. Cells outside of that range are blank.
+ * The state and symbol widths come first, so tm_resume() can reject machines packed with other TM_WIDE_* settings.
+*/
+typedef struct {
+    unsigned char state_size;
+    unsigned char symbol_size;
+    tm_tape_numeric_t tape_length;
+    tm_tape_numeric_t head;
+    tm_tape_numeric_t min_head;
+    tm_tape_numeric_t max_head;
+    tm_stat_step_numeric_t num_steps;
+    tm_state_t state;
+    tm_state_t num_states;
+    tm_symbol_t num_symbols;
+} tm_suspend_header_t;
+
+static unsigned char* tm_suspend_put(unsigned char* p, const void* src, size_t size) {
+    memcpy(p, src, size);
+    return p + size;
+}
+
+static unsigned char* tm_suspend_get(unsigned char* p, void* dst, size_t size) {
+    memcpy(dst, p, size);
+    return p + size;
+}
+
+size_t tm_suspend_size(turing_machine_t* tm, turing_machine_stat_t* tm_stat) {
+    size_t num_transitions = (size_t)tm->num_states * tm->num_symbols;
+    return sizeof(tm_suspend_header_t)
+        + num_transitions * (sizeof(tm_symbol_t) + 1 + sizeof(tm_state_t))
+        + (size_t)tm->num_symbols * (sizeof(tm_stat_read_numeric_t) + sizeof(tm_stat_write_numeric_t))
+        + (size_t)tm->num_states * sizeof(tm_stat_step_numeric_t)
+        + (size_t)(tm_stat->max_head - tm_stat->min_head + 1) * sizeof(tm_symbol_t);
+}
+
+/**
+ * Packs the machine and its statistics into buffer, which must hold at least tm_suspend_size() bytes
+ * @returns Number of bytes written
+*/
+size_t tm_suspend(turing_machine_t* tm, turing_machine_stat_t* tm_stat, unsigned char* buffer) {
+    tm_suspend_header_t header;
+    // Keep the padding deterministic, the header is copied as a whole
+    memset(&header, 0, sizeof(header));
+    header.state_size = sizeof(tm_state_t);
+    header.symbol_size = sizeof(tm_symbol_t);
+    header.tape_length = tm->tape_length;
+    header.head = tm->head;
+    header.min_head = tm_stat->min_head;
+    header.max_head = tm_stat->max_head;
+    header.num_steps = tm_stat->num_steps;
+    header.state = tm->state;
+    header.num_states = tm->num_states;
+    header.num_symbols = tm->num_symbols;
+
+    unsigned char* p = tm_suspend_put(buffer, &header, sizeof(header));
+    for (tm_state_t i = 0; i < tm->num_states; i++) {
+        for (tm_symbol_t j = 0; j < tm->num_symbols; j++) {
+            tm_state_transition_t* t = &tm->transition_bundles[i].transitions[j];
+            unsigned char head_direction = (unsigned char)t->head_direction;
+            p = tm_suspend_put(p, &t->write_symbol, sizeof(tm_symbol_t));
+            p = tm_suspend_put(p, &head_direction, 1);
+            p = tm_suspend_put(p, &t->state, sizeof(tm_state_t));
+        }
+    }
+    p = tm_suspend_put(p, tm_stat->reads, tm->num_symbols * sizeof(tm_stat_read_numeric_t));
+    p = tm_suspend_put(p, tm_stat->writes, tm->num_symbols * sizeof(tm_stat_write_numeric_t));
+    p = tm_suspend_put(p, tm_stat->state_visits, tm->num_states * sizeof(tm_stat_step_numeric_t));
+    p = tm_suspend_put(p, tm->tape + tm_stat->min_head, (tm_stat->max_head - tm_stat->min_head + 1) * sizeof(tm_symbol_t));
+    return (size_t)(p - buffer);
+}
+
+/**
+ * Restores a machine and its statistics packed by tm_suspend()
+ * @param arena If not null, storage for tm and tm_stat is allocated from it,
+ *              otherwise tm and tm_stat must already have storage of the suspended dimensions
+ * @param tape_length 0 to keep the suspended tape, otherwise the visited cells are re-centred on a tape of tape_length cells
+ * @note Fully initializes tm and tm_stat, no need to call tm_init() or tm_stat_init() beforehand
+*/
+void tm_resume(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_arena_t* arena, unsigned char* buffer, tm_tape_numeric_t tape_length) {
+    tm_suspend_header_t header;
+    if (buffer[0] != sizeof(tm_state_t) || buffer[1] != sizeof(tm_symbol_t)) {
+        tm_errorf("Suspended machine has %u-byte states and %u-byte symbols, expected %u and %u (see TM_WIDE_STATES and TM_WIDE_SYMBOLS)\n",
+                  (unsigned int)buffer[0], (unsigned int)buffer[1], (unsigned int)sizeof(tm_state_t), (unsigned int)sizeof(tm_symbol_t));
+    }
+    unsigned char* p = tm_suspend_get(buffer, &header, sizeof(header));
+
+    tm_tape_numeric_t num_visited = header.max_head - header.min_head + 1;
+    tm_tape_numeric_t min_head = header.min_head;
+    if (tape_length == 0) {
+        tape_length = header.tape_length;
+    }
+    else if (tape_length < num_visited) {
+        tm_errorf("Tape of %u cells can't hold the %u visited cells of the suspended machine\n", tape_length, num_visited);
+    }
+    else {
+        min_head = (tape_length - num_visited) / 2;
+    }
+
+    if (arena != NULL) {
+        tm_alloc(tm, arena, header.num_states, header.num_symbols, tape_length);
+        tm_stat_alloc(tm_stat, arena, tm);
+    }
+    else if (tm->num_states != header.num_states || tm->num_symbols != header.num_symbols || tm->tape_length != tape_length
+             || tm_stat->tm_num_states != header.num_states || tm_stat->tm_num_symbols != header.num_symbols) {
+        tm_error("Suspended machine dimensions differ from the target machine\n");
+    }
+    tm_init(tm);
+    tm_stat_init(tm_stat, tm);
+    tm->head = min_head + (header.head - header.min_head);
+    tm->state = header.state;
+    tm_stat->min_head = min_head;
+    tm_stat->max_head = min_head + num_visited - 1;
+    tm_stat->num_steps = header.num_steps;
+
+    for (tm_state_t i = 0; i < header.num_states; i++) {
+        tm_transition_bundle_t* tb = &tm->transition_bundles[i];
+        tb->bundle_size = header.num_symbols;
+        for (tm_symbol_t j = 0; j < header.num_symbols; j++) {
+            tm_state_transition_t* t = &tb->transitions[j];
+            unsigned char head_direction;
+            t->read_symbol = j;
+            p = tm_suspend_get(p, &t->write_symbol, sizeof(tm_symbol_t));
+            p = tm_suspend_get(p, &head_direction, 1);
+            p = tm_suspend_get(p, &t->state, sizeof(tm_state_t));
+            t->head_direction = (tm_head_dir_t)head_direction;
+        }
+    }
+    #ifdef TM_GUARDS
+    tm->transition_bundles_initialized = TM_GUARD_OK;
+    #endif
+
+    p = tm_suspend_get(p, tm_stat->reads, header.num_symbols * sizeof(tm_stat_read_numeric_t));
+    p = tm_suspend_get(p, tm_stat->writes, header.num_symbols * sizeof(tm_stat_write_numeric_t));
+    p = tm_suspend_get(p, tm_stat->state_visits, header.num_states * sizeof(tm_stat_step_numeric_t));
+    tm_suspend_get(p, tm->tape + min_head, num_visited * sizeof(tm_symbol_t));
+}
+#endif
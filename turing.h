@@ -1,19 +1,37 @@
+//#define TM_WIDE_STATES // 16-bit states, for machines with more than 254 states
+//#define TM_WIDE_SYMBOLS // 16-bit symbols, for machines with more than 255 symbols (doubles tape memory)
+
+#include <stddef.h>
+
+#ifdef TM_WIDE_STATES
+typedef unsigned short tm_state_t;
+#define TM_HALT_STATE 0xFFFFU
+#else
 typedef unsigned char tm_state_t;
+#define TM_HALT_STATE 0xFFU
+#endif
+
+#ifdef TM_WIDE_SYMBOLS
+typedef unsigned short tm_symbol_t;
+#define TM_SYMBOL_LIMIT 0x10000U
+#else
 typedef unsigned char tm_symbol_t;
+#define TM_SYMBOL_LIMIT 0x100U
+#endif
+
 typedef unsigned int tm_tape_numeric_t;
 
 typedef unsigned int tm_stat_step_numeric_t;
 typedef unsigned int tm_stat_read_numeric_t;
 typedef unsigned int tm_stat_write_numeric_t;
 
-#define TM_HALT_STATE 0xFFU
 #define TM_INIT_STATE 0U
 #define TM_BLANK_SYMBOL 0U
-#define TM_INIT_HEAD 500U
 
-#define TM_TAPE_LENGTH 1000U
-#define TM_MAX_STATES 100U
-#define TM_MAX_SYMBOLS 10
+#define TM_DEFAULT_TAPE_LENGTH 1000U // default tape length of machines loaded by tm_from_file(), the head starts in the middle
+#define TM_MAX_NAME_LENGTH 63 // state, symbol and head direction names in *.tm files
+#define TM_ARENA_DEFAULT_BLOCK_SIZE (64U * 1024U)
+#define TM_ARENA_ALIGNMENT 16U
 
 #define TM_GUARDS
 #define TM_STDOUT_OUTPUT
@@ -21,6 +39,7 @@ typedef unsigned int tm_stat_write_numeric_t;
 #define TM_STREAM_OUTPUT
 #define TM_STAT_INTERFACE
 #define TM_FILE_INTERFACE
+#define TM_SUSPEND_INTERFACE
 //#define TM_DEBUG
 
 typedef enum {
@@ -36,10 +55,27 @@ typedef struct {
 } tm_state_transition_t;
 
 typedef struct {
-    tm_state_transition_t transitions[TM_MAX_SYMBOLS];
+    tm_state_transition_t* transitions; // num_symbols entries
     tm_symbol_t bundle_size;
 } tm_transition_bundle_t;
 
+/**
+ * Bump allocator for machine storage.
+ * Allocations live until tm_arena_reset(), which recycles all blocks at once; there is no per-allocation free.
+*/
+typedef struct tm_arena_block {
+    struct tm_arena_block* next;
+    size_t size;
+    size_t used;
+    unsigned char* data;
+} tm_arena_block_t;
+
+typedef struct {
+    tm_arena_block_t* first;
+    tm_arena_block_t* current;
+    size_t block_size;
+} tm_arena_t;
+
 #ifdef TM_GUARDS
 typedef enum {
     TM_GUARD_OK,
@@ -48,10 +84,11 @@ typedef enum {
 #endif
 
 typedef struct {
-    tm_symbol_t tape[TM_TAPE_LENGTH];
+    tm_symbol_t* tape; // tape_length cells
+    tm_tape_numeric_t tape_length;
     tm_tape_numeric_t head;
     tm_state_t state; // target state
-    tm_transition_bundle_t transition_bundles[TM_MAX_STATES];
+    tm_transition_bundle_t* transition_bundles; // num_states bundles
     #ifdef TM_GUARDS
     tm_initialization_guard_t transition_bundles_initialized;
     #endif
@@ -69,9 +106,25 @@ typedef enum {
     TM_STATUS_HALTED
 } turing_machine_status_t;
 
+typedef enum {
+    TM_RUN_BUDGET_EXHAUSTED,
+    TM_RUN_HALTED,
+    TM_RUN_TAPE_BOUNDARY
+} tm_run_result_t;
+
+void tm_arena_init(tm_arena_t* arena, size_t block_size);
+
+void* tm_arena_alloc(tm_arena_t* arena, size_t size);
+
+void tm_arena_reset(tm_arena_t* arena);
+
+void tm_arena_free(tm_arena_t* arena);
+
+void tm_alloc(turing_machine_t* tm, tm_arena_t* arena, tm_state_t num_states, tm_symbol_t num_symbols, tm_tape_numeric_t tape_length);
+
 void tm_init_tape(turing_machine_t* tm);
 
-void tm_init(turing_machine_t* tm, tm_state_t num_states, tm_symbol_t num_symbols);
+void tm_init(turing_machine_t* tm);
 
 void tm_print_tape(turing_machine_t* tm);
 
@@ -83,28 +136,45 @@ tm_state_transition_t* tm_get_transition(turing_machine_t* tm);
 
 turing_machine_status_t tm_get_status(turing_machine_t* tm);
 
+void tm_error(char* message);
+
+void tm_errorf(char* format, ...);
+
 
 #ifdef TM_STAT_INTERFACE
 typedef struct {
     tm_tape_numeric_t min_head;
     tm_tape_numeric_t max_head;
     tm_stat_step_numeric_t num_steps;
-    tm_stat_read_numeric_t reads[TM_MAX_SYMBOLS];
-    tm_stat_write_numeric_t writes[TM_MAX_SYMBOLS];
-    tm_stat_step_numeric_t state_visits[TM_MAX_STATES];
+    tm_stat_read_numeric_t* reads; // tm_num_symbols entries
+    tm_stat_write_numeric_t* writes; // tm_num_symbols entries
+    tm_stat_step_numeric_t* state_visits; // tm_num_states entries
     tm_symbol_t tm_num_symbols;
+    tm_state_t tm_num_states;
 } turing_machine_stat_t;
 
 void tm_make_transition(turing_machine_t* tm, turing_machine_stat_t* tm_stat);
 
-void tm_stat_init(turing_machine_stat_t* tm_stat, tm_symbol_t tm_num_symbols, tm_state_t tm_num_states);
+tm_run_result_t tm_run(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_stat_step_numeric_t max_steps);
 
-void tm_error(char* message);
+void tm_stat_alloc(turing_machine_stat_t* tm_stat, tm_arena_t* arena, turing_machine_t* tm);
+
+void tm_stat_init(turing_machine_stat_t* tm_stat, turing_machine_t* tm);
 
 #else
 void tm_make_transition(turing_machine_t* tm);
+
+tm_run_result_t tm_run(turing_machine_t* tm, tm_stat_step_numeric_t max_steps);
 #endif
 
 #ifdef TM_FILE_INTERFACE
-void tm_from_file(turing_machine_t* tm, char* path);
+void tm_from_file(turing_machine_t* tm, tm_arena_t* arena, char* path, tm_tape_numeric_t tape_length);
+#endif
+
+#if defined(TM_SUSPEND_INTERFACE) && defined(TM_STAT_INTERFACE)
+size_t tm_suspend_size(turing_machine_t* tm, turing_machine_stat_t* tm_stat);
+
+size_t tm_suspend(turing_machine_t* tm, turing_machine_stat_t* tm_stat, unsigned char* buffer);
+
+void tm_resume(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tm_arena_t* arena, unsigned char* buffer, tm_tape_numeric_t tape_length);
 #endif
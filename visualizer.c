@@ -2,12 +2,105 @@
 #include <SDL2/SDL_ttf.h>
 #include <pthread.h>
 #include <math.h>
+#include <string.h>
 
 SDL_Window   *m_window          = NULL;
 SDL_Renderer *m_window_renderer = NULL;
 SDL_Event     m_window_event;
 unsigned int window_width = VISUALIZER_WINDOW_WIDTH;
 unsigned int window_height = VISUALIZER_WINDOW_HEIGHT;
+tm_arena_t visualization_arena = { NULL, NULL, TM_ARENA_DEFAULT_BLOCK_SIZE }; // machines and stats, main thread only
+
+/**
+ * Part of the tape shown in a diagram, num_cells cells from first, always inside the tape.
+ * It starts centred on the head and is re-centred on it when the head leaves it.
+*/
+typedef struct {
+    tm_tape_numeric_t first;
+    tm_tape_numeric_t num_cells;
+} tape_window_t;
+
+/**
+ * One machine of the grid view.
+ * The worker thread appends a time-compressed row of pixels per block of steps to a ring of GRID_TILE_HISTORY_ROWS rows,
+ * the render loop uploads new rows to the tile's streaming texture.
+*/
+typedef struct {
+    char* tm_path;
+    turing_machine_t tm;
+    turing_machine_stat_t tm_stat;
+    tape_window_t window; // num_cells is the texture width
+    Uint32* pixels;
+    unsigned int rows_written; // guarded by mutex
+    tm_stat_step_numeric_t num_steps; // guarded by mutex
+    tm_run_result_t result; // guarded by mutex, TM_RUN_BUDGET_EXHAUSTED while running
+    unsigned int rows_uploaded; // render loop only
+    tm_stat_step_numeric_t shown_num_steps; // render loop only, num_steps and result as of the last upload
+    tm_run_result_t shown_result;
+    SDL_Texture* texture;
+    pthread_mutex_t mutex;
+    pthread_t worker;
+} grid_tile_t;
+
+typedef struct {
+    grid_tile_t* tiles;
+    unsigned int num_tiles;
+    volatile unsigned int cols;
+    volatile unsigned int rows;
+    volatile int selected;
+    volatile int focused; // -1 if no tile is expanded
+} grid_view_t;
+
+grid_view_t grid_view = { NULL, 0, 1, 1, 0, -1 };
+
+/**
+ * Mouse: click a tile to expand it to full screen, click again to go back to the grid.
+ * Keyboard: arrows move the selection, Enter/Space expands or collapses the selected tile, Escape collapses.
+*/
+void handle_grid_event(SDL_Event* event) {
+    if (grid_view.num_tiles == 0) {
+        return;
+    }
+    int selected = grid_view.selected;
+    int cols = grid_view.cols;
+    switch (event->type) {
+        case SDL_MOUSEBUTTONDOWN:
+            if (grid_view.focused >= 0) {
+                grid_view.focused = -1;
+            }
+            else {
+                int col = event->button.x * cols / (int)window_width;
+                int row = event->button.y * (int)grid_view.rows / (int)window_height;
+                int index = row * cols + col;
+                if (index < (int)grid_view.num_tiles) {
+                    grid_view.selected = index;
+                    grid_view.focused = index;
+                }
+            }
+            break;
+        case SDL_KEYDOWN:
+            switch (event->key.keysym.sym) {
+                case SDLK_LEFT:  selected -= 1; break;
+                case SDLK_RIGHT: selected += 1; break;
+                case SDLK_UP:    selected -= cols; break;
+                case SDLK_DOWN:  selected += cols; break;
+                case SDLK_RETURN:
+                case SDLK_SPACE:
+                    grid_view.focused = grid_view.focused >= 0 ? -1 : grid_view.selected;
+                    break;
+                case SDLK_ESCAPE:
+                    grid_view.focused = -1;
+                    break;
+            }
+            if (selected >= 0 && selected < (int)grid_view.num_tiles) {
+                grid_view.selected = selected;
+                if (grid_view.focused >= 0) {
+                    grid_view.focused = selected;
+                }
+            }
+            break;
+    }
+}
 
 void* eventListenerThreadHandler(void* arg_p) {
     while(1)
@@ -19,6 +112,10 @@ void* eventListenerThreadHandler(void* arg_p) {
                 SDL_DestroyRenderer(m_window_renderer);
                 SDL_DestroyWindow(m_window);
                 exit(0);
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_KEYDOWN:
+                handle_grid_event(&m_window_event);
+                break;
         }
         //update(1.0/60.0, &x, &y);
         //draw(m_window_renderer, x, y);
@@ -39,7 +136,10 @@ void render_counter(unsigned int counter) {
     SDL_RenderFillRect(m_window_renderer, &rect);
     SDL_RenderCopy(m_window_renderer, NULL, &rect, &rect);
 
-    TTF_Font* Sans = TTF_OpenFont("../assets/fonts/OpenSans-SemiboldItalic.ttf", 24);
+    static TTF_Font* Sans = NULL;
+    if (Sans == NULL) {
+        Sans = TTF_OpenFont("../assets/fonts/OpenSans-SemiboldItalic.ttf", 24);
+    }
     if (Sans == NULL) {
         printf("TTF_OpenFont: %s\n", TTF_GetError());
         return;
@@ -85,6 +185,51 @@ void clear_window() {
     #endif
 }
 
+void center_tape_window(tape_window_t* window, turing_machine_t* tm) {
+    tm_tape_numeric_t half = window->num_cells / 2;
+    tm_tape_numeric_t first = tm->head > half ? tm->head - half : 0;
+    window->first = first > tm->tape_length - window->num_cells ? tm->tape_length - window->num_cells : first;
+}
+
+void init_tape_window(tape_window_t* window, turing_machine_t* tm) {
+    window->num_cells = tm->tape_length < VISUALIZER_TAPE_CELLS ? tm->tape_length : VISUALIZER_TAPE_CELLS;
+    center_tape_window(window, tm);
+}
+
+/**
+ * @returns 1 if the head had left the window and it was re-centred
+*/
+int follow_head(tape_window_t* window, turing_machine_t* tm) {
+    if (tm->head >= window->first && tm->head - window->first < window->num_cells) {
+        return 0;
+    }
+    center_tape_window(window, tm);
+    return 1;
+}
+
+/**
+ * Color of a tape cell in the space-time diagram.
+ * Blank cells are grey inside the visited range and black outside of it, 1 is white, other symbols are blue.
+*/
+SDL_Color tape_cell_color(tm_symbol_t symbol, tm_tape_numeric_t tape_pos, turing_machine_stat_t* tm_stat) {
+    if (symbol == 0 && tape_pos >= tm_stat->min_head && tape_pos <= tm_stat->max_head) {
+        //return (SDL_Color){255, 0, 0, 255};
+        return (SDL_Color){100, 100, 100, 255};
+    }
+    else if (symbol == 0) {
+        return (SDL_Color){0, 0, 0, 255};
+    }
+    else if (symbol == 1) {
+        //return (SDL_Color){0, 255, 0, 255};
+        return (SDL_Color){255, 255, 255, 255};
+    }
+    return (SDL_Color){0, 0, 255, 255};
+}
+
+Uint32 color_to_argb8888(SDL_Color color) {
+    return ((Uint32)color.a << 24) | ((Uint32)color.r << 16) | ((Uint32)color.g << 8) | color.b;
+}
+
 /**
  * Render a row of red or green rectangles depending on the tape content.
  * If the tape content is 0, the rectangle is red, otherwise it is green.
@@ -93,8 +238,8 @@ void clear_window() {
  * The width of the tape is determined by the window width.
  * The height of the tape is determined by NUM_STEPS_PER_WINDOW and the window height.
 */
-void render_current_tm_tape(turing_machine_t* tm, turing_machine_stat_t* tm_stat) {
-    tm_tape_numeric_t render_tape_num_cells = MAX_TAPE_POS - MIN_TAPE_POS + 1;    
+void render_current_tm_tape(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tape_window_t* window) {
+    tm_tape_numeric_t render_tape_num_cells = window->num_cells;
     for (tm_tape_numeric_t i = 0; i < render_tape_num_cells; i++) {
         SDL_Rect rect;
         rect.x = i * window_width / render_tape_num_cells;
@@ -103,23 +248,11 @@ void render_current_tm_tape(turing_machine_t* tm, turing_machine_stat_t* tm_stat
         rect.w = window_width / render_tape_num_cells;
         rect.h = window_height / NUM_STEPS_PER_WINDOW;
 
-        tm_tape_numeric_t tape_pos = MIN_TAPE_POS + i;
+        tm_tape_numeric_t tape_pos = window->first + i;
         tm_symbol_t read_symbol = tm->tape[tape_pos];
         
-        if (read_symbol == 0 && tape_pos >= tm_stat->min_head && tape_pos <= tm_stat->max_head) {
-            //SDL_SetRenderDrawColor(m_window_renderer, 255, 0, 0, 255);
-            SDL_SetRenderDrawColor(m_window_renderer, 100, 100, 100, 255);
-        }
-        else if (read_symbol == 0) {
-            SDL_SetRenderDrawColor(m_window_renderer, 0, 0, 0, 255);
-        }
-        else if (read_symbol == 1) {
-            //SDL_SetRenderDrawColor(m_window_renderer, 0, 255, 0, 255);
-            SDL_SetRenderDrawColor(m_window_renderer, 255, 255, 255, 255);
-        }
-        else {
-            SDL_SetRenderDrawColor(m_window_renderer, 0, 0, 255, 255);
-        }
+        SDL_Color color = tape_cell_color(read_symbol, tape_pos, tm_stat);
+        SDL_SetRenderDrawColor(m_window_renderer, color.r, color.g, color.b, color.a);
 
         SDL_RenderFillRect(m_window_renderer, &rect);
         SDL_RenderCopy(m_window_renderer, NULL, &rect, &rect);
@@ -131,14 +264,18 @@ void render_current_tm_tape(turing_machine_t* tm, turing_machine_stat_t* tm_stat
 */
 void animate_tm(turing_machine_t* tm) {
     turing_machine_stat_t tm_stat;
-    tm_stat_init(&tm_stat, tm->num_symbols, tm->num_states);
+    tm_stat_alloc(&tm_stat, &visualization_arena, tm);
+    tm_stat_init(&tm_stat, tm);
+    tape_window_t window;
+    init_tape_window(&window, tm);
 
 
     while(tm_get_status(tm) == TM_STATUS_RUNNING) {
         printf("Frame\n");
         tm_make_transition(tm, &tm_stat);
+        follow_head(&window, tm);
         render_counter(tm_stat.num_steps);
-        render_current_tm_tape(tm, &tm_stat);
+        render_current_tm_tape(tm, &tm_stat, &window);
 
         if ((tm_stat.num_steps % NUM_STEPS_PER_WINDOW) == 0) {
             clear_window();
@@ -153,6 +290,332 @@ void animate_tm(turing_machine_t* tm) {
     }
 }
 
+/**
+ * Color of a cell in a time-compressed row: the tape at the end of the block, tinted red by the share of the block's steps the head spent on the cell
+*/
+SDL_Color compressed_cell_color(SDL_Color tape_color, unsigned int visits, unsigned int max_visits) {
+    if (visits == 0 || max_visits == 0) {
+        return tape_color;
+    }
+    unsigned int weight = 64 + 191 * visits / max_visits; // 0..255, visited cells are always visible
+    SDL_Color color;
+    color.r = (Uint8)((tape_color.r * (255 - weight) + 255 * weight) / 255);
+    color.g = (Uint8)(tape_color.g * (255 - weight) / 255);
+    color.b = (Uint8)(tape_color.b * (255 - weight) / 255);
+    color.a = 255;
+    return color;
+}
+
+/**
+ * Runs a block of steps_per_row steps in at most ADAPTIVE_VISIT_SAMPLES batched tm_run() calls and summarizes it as a row:
+ * the tape at the end of the block, tinted by how often the head was found on each cell between the calls.
+ * Blocks of fewer steps than ADAPTIVE_VISIT_SAMPLES see every step.
+ *
+ * @param visits Scratch buffer of window->num_cells entries
+ * @returns Result of the last tm_run() call
+*/
+tm_run_result_t run_compressed_row(turing_machine_t* tm, turing_machine_stat_t* tm_stat, tape_window_t* window, unsigned long steps_per_row, unsigned int* visits, Uint32* row) {
+    tm_run_result_t result = TM_RUN_BUDGET_EXHAUSTED;
+    unsigned int max_visits = 0;
+    unsigned long num_samples = steps_per_row < ADAPTIVE_VISIT_SAMPLES ? steps_per_row : ADAPTIVE_VISIT_SAMPLES;
+    memset(visits, 0, window->num_cells * sizeof(unsigned int));
+    for (unsigned long k = 0; k < num_samples && result == TM_RUN_BUDGET_EXHAUSTED; k++) {
+        // Spread the steps evenly over the samples, the first ones take the remainder
+        unsigned long batch = steps_per_row / num_samples + (k < steps_per_row % num_samples);
+        result = tm_run(tm, tm_stat, (tm_stat_step_numeric_t)batch);
+        if (tm->head >= window->first && tm->head - window->first < window->num_cells && ++visits[tm->head - window->first] > max_visits) {
+            max_visits = visits[tm->head - window->first];
+        }
+    }
+
+    if (follow_head(window, tm)) {
+        // The visits were counted in the previous window
+        max_visits = 0;
+    }
+    for (tm_tape_numeric_t i = 0; i < window->num_cells; i++) {
+        tm_tape_numeric_t tape_pos = window->first + i;
+        SDL_Color tape_color = tape_cell_color(tm->tape[tape_pos], tape_pos, tm_stat);
+        row[i] = color_to_argb8888(compressed_cell_color(tape_color, visits[i], max_visits));
+    }
+    return result;
+}
+
+/**
+ * Next block size, so that simulating steps_per_row steps takes about budget_ms; it changes by at most a factor of two per call
+*/
+unsigned long steer_steps_per_row(unsigned long steps_per_row, double sim_ms, double budget_ms) {
+    double target = sim_ms > 0 ? steps_per_row * budget_ms / sim_ms : 2.0 * steps_per_row;
+    if (target > 2.0 * steps_per_row) {
+        target = 2.0 * steps_per_row;
+    }
+    else if (target < 0.5 * steps_per_row) {
+        target = 0.5 * steps_per_row;
+    }
+    return target < 1 ? 1 : target > ADAPTIVE_MAX_STEPS_PER_ROW ? ADAPTIVE_MAX_STEPS_PER_ROW : (unsigned long)target;
+}
+
+const char* run_result_text(tm_run_result_t result) {
+    return result == TM_RUN_HALTED ? "halted" : result == TM_RUN_TAPE_BOUNDARY ? "head reached the end of the tape" : "running";
+}
+
+/**
+ * Simulates the tile's machine in blocks of steps that follow the simulation speed like animate_tm_adaptive(),
+ * one compressed row per block, at most one row per GRID_ROW_DURATION_MS
+*/
+void* gridTileWorkerThreadHandler(void* arg_p) {
+    grid_tile_t* tile = (grid_tile_t*)arg_p;
+    tm_tape_numeric_t render_tape_num_cells = tile->window.num_cells;
+    Uint32* row = malloc(render_tape_num_cells * sizeof(Uint32));
+    unsigned int* visits = malloc(render_tape_num_cells * sizeof(unsigned int));
+    if (row == NULL || visits == NULL) {
+        fprintf(stderr, "Error: could not allocate tile row!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned long steps_per_row = 1;
+    double ticks_per_ms = SDL_GetPerformanceFrequency() / 1000.0;
+    tm_run_result_t result = TM_RUN_BUDGET_EXHAUSTED;
+    while (result == TM_RUN_BUDGET_EXHAUSTED) {
+        Uint32 row_start = SDL_GetTicks();
+        Uint64 sim_start = SDL_GetPerformanceCounter();
+        result = run_compressed_row(&tile->tm, &tile->tm_stat, &tile->window, steps_per_row, visits, row);
+        double sim_ms = (SDL_GetPerformanceCounter() - sim_start) / ticks_per_ms;
+
+        pthread_mutex_lock(&tile->mutex);
+        memcpy(tile->pixels + (tile->rows_written % GRID_TILE_HISTORY_ROWS) * render_tape_num_cells, row, render_tape_num_cells * sizeof(Uint32));
+        tile->rows_written++;
+        tile->num_steps = tile->tm_stat.num_steps;
+        tile->result = result;
+        pthread_mutex_unlock(&tile->mutex);
+
+        if (result == TM_RUN_BUDGET_EXHAUSTED) {
+            steps_per_row = steer_steps_per_row(steps_per_row, sim_ms, GRID_ROW_SIM_BUDGET_MS);
+            Uint32 row_ms = SDL_GetTicks() - row_start;
+            if (row_ms < GRID_ROW_DURATION_MS) {
+                SDL_Delay(GRID_ROW_DURATION_MS - row_ms);
+            }
+        }
+    }
+    fprintf(stderr, "%s: %s after %u steps\n", tile->tm_path, run_result_text(result), tile->tm_stat.num_steps);
+    free(row);
+    free(visits);
+    return NULL;
+}
+
+/**
+ * Picks the number of columns and rows that makes the tiles as large as possible (by their shorter side) for the window size
+*/
+void compute_grid_layout(unsigned int num_tiles, unsigned int* cols, unsigned int* rows) {
+    unsigned int best_size = 0;
+    *cols = 1;
+    *rows = num_tiles;
+    for (unsigned int c = 1; c <= num_tiles; c++) {
+        unsigned int r = (num_tiles + c - 1) / c;
+        unsigned int tile_width = window_width / c;
+        unsigned int tile_height = window_height / r;
+        unsigned int size = tile_width < tile_height ? tile_width : tile_height;
+        if (size > best_size) {
+            best_size = size;
+            *cols = c;
+            *rows = r;
+        }
+    }
+}
+
+/**
+ * Uploads the rows written since the previous frame to the tile's texture (at most two partial updates because of the ring)
+*/
+void upload_grid_tile(grid_tile_t* tile) {
+    tm_tape_numeric_t render_tape_num_cells = tile->window.num_cells;
+    pthread_mutex_lock(&tile->mutex);
+    unsigned int pending = tile->rows_written - tile->rows_uploaded;
+    if (pending > GRID_TILE_HISTORY_ROWS) {
+        pending = GRID_TILE_HISTORY_ROWS;
+    }
+    unsigned int first = (tile->rows_written - pending) % GRID_TILE_HISTORY_ROWS;
+    while (pending > 0) {
+        unsigned int count = pending < GRID_TILE_HISTORY_ROWS - first ? pending : GRID_TILE_HISTORY_ROWS - first;
+        SDL_Rect rect = { 0, (int)first, (int)render_tape_num_cells, (int)count };
+        SDL_UpdateTexture(tile->texture, &rect, tile->pixels + first * render_tape_num_cells, render_tape_num_cells * sizeof(Uint32));
+        pending -= count;
+        first = (first + count) % GRID_TILE_HISTORY_ROWS;
+    }
+    tile->rows_uploaded = tile->rows_written;
+    tile->shown_num_steps = tile->num_steps;
+    tile->shown_result = tile->result;
+    pthread_mutex_unlock(&tile->mutex);
+}
+
+/**
+ * Draws a texture used as a ring of num_rows rows into dst with the latest row at the bottom, so the diagram scrolls up
+*/
+void render_ring_texture(SDL_Texture* texture, unsigned int rows_written, int num_rows, int num_cols, SDL_Rect* dst) {
+    int oldest = rows_written % num_rows;
+    int split = dst->y + (num_rows - oldest) * dst->h / num_rows;
+
+    SDL_Rect src_old = { 0, oldest, num_cols, num_rows - oldest };
+    SDL_Rect dst_old = { dst->x, dst->y, dst->w, split - dst->y };
+    SDL_RenderCopy(m_window_renderer, texture, &src_old, &dst_old);
+
+    if (oldest > 0) {
+        SDL_Rect src_new = { 0, 0, num_cols, oldest };
+        SDL_Rect dst_new = { dst->x, split, dst->w, dst->y + dst->h - split };
+        SDL_RenderCopy(m_window_renderer, texture, &src_new, &dst_new);
+    }
+}
+
+/**
+ * Finished tiles get a frame inside the selection frame, green when halted and red when the head reached the end of the tape
+*/
+void render_grid_tile(grid_tile_t* tile, SDL_Rect* dst) {
+    render_ring_texture(tile->texture, tile->rows_uploaded, GRID_TILE_HISTORY_ROWS, tile->window.num_cells, dst);
+    if (tile->shown_result != TM_RUN_BUDGET_EXHAUSTED) {
+        int halted = tile->shown_result == TM_RUN_HALTED;
+        SDL_Rect frame = { dst->x + 1, dst->y + 1, dst->w - 2, dst->h - 2 };
+        SDL_SetRenderDrawColor(m_window_renderer, halted ? 0 : 255, halted ? 255 : 0, 0, 255);
+        SDL_RenderDrawRect(m_window_renderer, &frame);
+    }
+}
+
+/**
+ * Render loop of the grid view, paced by vsync
+*/
+void animate_tm_grid() {
+    int title_focused = -2;
+    tm_run_result_t title_result = TM_RUN_BUDGET_EXHAUSTED;
+    while (1) {
+        unsigned int cols, rows;
+        compute_grid_layout(grid_view.num_tiles, &cols, &rows);
+        grid_view.cols = cols;
+        grid_view.rows = rows;
+
+        for (unsigned int i = 0; i < grid_view.num_tiles; i++) {
+            upload_grid_tile(&grid_view.tiles[i]);
+        }
+
+        SDL_SetRenderDrawColor(m_window_renderer, 0, 0, 0, 255);
+        SDL_RenderClear(m_window_renderer);
+
+        int focused = grid_view.focused;
+        if (focused >= 0) {
+            SDL_Rect rect = { 0, 0, (int)window_width, (int)window_height };
+            render_grid_tile(&grid_view.tiles[focused], &rect);
+        }
+        else {
+            int tile_width = window_width / cols;
+            int tile_height = window_height / rows;
+            for (unsigned int i = 0; i < grid_view.num_tiles; i++) {
+                // 1px gap between tiles
+                SDL_Rect rect = { (int)(i % cols) * tile_width, (int)(i / cols) * tile_height, tile_width - 1, tile_height - 1 };
+                render_grid_tile(&grid_view.tiles[i], &rect);
+                if ((int)i == grid_view.selected) {
+                    SDL_SetRenderDrawColor(m_window_renderer, 255, 255, 0, 255);
+                    SDL_RenderDrawRect(m_window_renderer, &rect);
+                }
+            }
+        }
+
+        tm_run_result_t focused_result = focused >= 0 ? grid_view.tiles[focused].shown_result : TM_RUN_BUDGET_EXHAUSTED;
+        if (focused != title_focused || focused_result != title_result) {
+            char title[256];
+            if (focused < 0) {
+                snprintf(title, sizeof(title), "TM Visualizer");
+            }
+            else if (focused_result == TM_RUN_BUDGET_EXHAUSTED) {
+                snprintf(title, sizeof(title), "TM Visualizer - %s", grid_view.tiles[focused].tm_path);
+            }
+            else {
+                snprintf(title, sizeof(title), "TM Visualizer - %s - %s after %u steps", grid_view.tiles[focused].tm_path, run_result_text(focused_result), grid_view.tiles[focused].shown_num_steps);
+            }
+            SDL_SetWindowTitle(m_window, title);
+            title_focused = focused;
+            title_result = focused_result;
+        }
+
+        SDL_RenderPresent(m_window_renderer);
+    }
+}
+
+/**
+ * Adaptive time compression
+ * Every frame appends ADAPTIVE_ROWS_PER_FRAME rows to a scrolling diagram of ADAPTIVE_ROWS_PER_WINDOW rows.
+ * Each row summarizes a block of steps_per_row steps (see run_compressed_row()).
+ * steps_per_row follows the measured simulation speed so that simulating a frame takes about ADAPTIVE_SIM_BUDGET_MS.
+ * Once the machine halts or its head reaches the end of the tape, the outcome is shown in the title and the last frame stays.
+*/
+void animate_tm_adaptive(turing_machine_t* tm) {
+    turing_machine_stat_t tm_stat;
+    tm_stat_alloc(&tm_stat, &visualization_arena, tm);
+    tm_stat_init(&tm_stat, tm);
+    tape_window_t window;
+    init_tape_window(&window, tm);
+
+    tm_tape_numeric_t render_tape_num_cells = window.num_cells;
+    SDL_Texture* texture = SDL_CreateTexture(m_window_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, render_tape_num_cells, ADAPTIVE_ROWS_PER_WINDOW);
+    Uint32* row = malloc(render_tape_num_cells * sizeof(Uint32));
+    unsigned int* visits = malloc(render_tape_num_cells * sizeof(unsigned int));
+    if (texture == NULL || row == NULL || visits == NULL) {
+        fprintf(stderr, "Error: could not allocate adaptive view!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (tm_tape_numeric_t i = 0; i < render_tape_num_cells; i++) {
+        row[i] = 0xFF000000; // opaque black
+    }
+    for (unsigned int i = 0; i < ADAPTIVE_ROWS_PER_WINDOW; i++) {
+        SDL_Rect rect = { 0, (int)i, (int)render_tape_num_cells, 1 };
+        SDL_UpdateTexture(texture, &rect, row, render_tape_num_cells * sizeof(Uint32));
+    }
+
+    unsigned int rows_written = 0;
+    unsigned long steps_per_row = 1;
+    unsigned long title_steps_per_row = 0;
+    tm_run_result_t result = TM_RUN_BUDGET_EXHAUSTED;
+    double ticks_per_ms = SDL_GetPerformanceFrequency() / 1000.0;
+
+    while (result == TM_RUN_BUDGET_EXHAUSTED) {
+        Uint32 frame_start = SDL_GetTicks();
+
+        Uint64 sim_start = SDL_GetPerformanceCounter();
+        for (unsigned int r = 0; r < ADAPTIVE_ROWS_PER_FRAME && result == TM_RUN_BUDGET_EXHAUSTED; r++) {
+            result = run_compressed_row(tm, &tm_stat, &window, steps_per_row, visits, row);
+            SDL_Rect rect = { 0, (int)(rows_written % ADAPTIVE_ROWS_PER_WINDOW), (int)render_tape_num_cells, 1 };
+            SDL_UpdateTexture(texture, &rect, row, render_tape_num_cells * sizeof(Uint32));
+            rows_written++;
+        }
+        double sim_ms = (SDL_GetPerformanceCounter() - sim_start) / ticks_per_ms;
+        if (result == TM_RUN_BUDGET_EXHAUSTED) {
+            steps_per_row = steer_steps_per_row(steps_per_row, sim_ms, ADAPTIVE_SIM_BUDGET_MS);
+        }
+
+        SDL_Rect window_rect = { 0, 0, (int)window_width, (int)window_height };
+        render_ring_texture(texture, rows_written, ADAPTIVE_ROWS_PER_WINDOW, render_tape_num_cells, &window_rect);
+        render_counter(tm_stat.num_steps);
+        SDL_RenderPresent(m_window_renderer);
+
+        if (steps_per_row != title_steps_per_row && result == TM_RUN_BUDGET_EXHAUSTED) {
+            char title[64];
+            snprintf(title, sizeof(title), "TM Visualizer - %lu steps/row", steps_per_row);
+            SDL_SetWindowTitle(m_window, title);
+            title_steps_per_row = steps_per_row;
+        }
+
+        Uint32 frame_ms = SDL_GetTicks() - frame_start;
+        if (frame_ms < FRAME_DURATION_MS) {
+            SDL_Delay(FRAME_DURATION_MS - frame_ms);
+        }
+    }
+
+    char title[96];
+    snprintf(title, sizeof(title), "TM Visualizer - %s after %u steps", run_result_text(result), tm_stat.num_steps);
+    SDL_SetWindowTitle(m_window, title);
+    fprintf(stderr, "%s\n", title + strlen("TM Visualizer - "));
+    free(row);
+    free(visits);
+    while (1) {
+        SDL_Delay(FRAME_DURATION_MS);
+    }
+}
+
 int init_ttf() {
     if (TTF_Init() < 0) {
         printf("TTF_Init: %s\n", TTF_GetError());
@@ -209,15 +672,19 @@ int display_tm_visualization_window() {
     return 0;
 }
 
-void load_visualization_tm(char* tm_path) {
+void load_visualization_tm(char* tm_path, tm_tape_numeric_t tape_length) {
     if (tm_path == NULL) {
         fprintf(stderr, "Error: tm_path is NULL!\n");
         exit(EXIT_FAILURE);
     }
     
     turing_machine_t tm;
-    tm_from_file(&tm, tm_path);
+    tm_from_file(&tm, &visualization_arena, tm_path, tape_length);
+    #ifdef ADAPTIVE_TIME_COMPRESSION
+    animate_tm_adaptive(&tm);
+    #else
     animate_tm(&tm);
+    #endif
 
     /*cvrptw_problem_t problem = cvrptw_data_get(problem_path);
     
@@ -234,4 +701,62 @@ void load_visualization_tm(char* tm_path) {
     animate_problem_with_solution(problem, solution);
     */
     
+}
+
+/**
+ * Tiles the space-time diagrams of several machines, each simulated by its own worker thread
+*/
+void load_visualization_tm_grid(char** tm_paths, unsigned int num_tms, tm_tape_numeric_t tape_length) {
+    if (tm_paths == NULL || num_tms == 0) {
+        fprintf(stderr, "Error: no tm_paths given!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (num_tms > GRID_MAX_TILES) {
+        fprintf(stderr, "Error: at most %u machines can be shown in the grid!\n", GRID_MAX_TILES);
+        exit(EXIT_FAILURE);
+    }
+
+    grid_tile_t* tiles = calloc(num_tms, sizeof(grid_tile_t));
+    if (tiles == NULL) {
+        fprintf(stderr, "Error: could not allocate grid tiles!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned int i = 0; i < num_tms; i++) {
+        grid_tile_t* tile = &tiles[i];
+        tile->tm_path = tm_paths[i];
+        tm_from_file(&tile->tm, &visualization_arena, tm_paths[i], tape_length);
+        tm_stat_alloc(&tile->tm_stat, &visualization_arena, &tile->tm);
+        tm_stat_init(&tile->tm_stat, &tile->tm);
+        init_tape_window(&tile->window, &tile->tm);
+        tile->result = TM_RUN_BUDGET_EXHAUSTED;
+        tile->shown_result = TM_RUN_BUDGET_EXHAUSTED;
+        tm_tape_numeric_t render_tape_num_cells = tile->window.num_cells;
+
+        tile->pixels = malloc(GRID_TILE_HISTORY_ROWS * render_tape_num_cells * sizeof(Uint32));
+        if (tile->pixels == NULL) {
+            fprintf(stderr, "Error: could not allocate tile pixels!\n");
+            exit(EXIT_FAILURE);
+        }
+        for (unsigned int j = 0; j < GRID_TILE_HISTORY_ROWS * render_tape_num_cells; j++) {
+            tile->pixels[j] = 0xFF000000; // opaque black
+        }
+
+        tile->texture = SDL_CreateTexture(m_window_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, render_tape_num_cells, GRID_TILE_HISTORY_ROWS);
+        if (tile->texture == NULL) {
+            printf("Failed to create tile texture\n");
+            printf("SDL2 Error: %s\n", SDL_GetError());
+            exit(EXIT_FAILURE);
+        }
+        SDL_UpdateTexture(tile->texture, NULL, tile->pixels, render_tape_num_cells * sizeof(Uint32));
+        pthread_mutex_init(&tile->mutex, NULL);
+    }
+
+    grid_view.tiles = tiles;
+    grid_view.num_tiles = num_tms;
+
+    for (unsigned int i = 0; i < num_tms; i++) {
+        pthread_create(&tiles[i].worker, NULL, gridTileWorkerThreadHandler, &tiles[i]);
+    }
+    animate_tm_grid();
 }
\ No newline at end of file
@@ -7,13 +7,26 @@
 
 #define FRAME_DURATION_MS 20
 #define NUM_STEPS_PER_WINDOW 1000
-#define MIN_TAPE_POS 300//450
-#define MAX_TAPE_POS 700//550
+#define VISUALIZER_TAPE_CELLS 401//101 // widest part of the tape shown, clamped to the tape length
+
+#define ADAPTIVE_TIME_COMPRESSION // comment out to draw one row per step
+#define ADAPTIVE_ROWS_PER_WINDOW NUM_STEPS_PER_WINDOW
+#define ADAPTIVE_ROWS_PER_FRAME 4
+#define ADAPTIVE_SIM_BUDGET_MS 10
+#define ADAPTIVE_MAX_STEPS_PER_ROW (1UL << 30)
+#define ADAPTIVE_VISIT_SAMPLES 256 // tm_run() calls per row, the head position is sampled after each
+
+#define GRID_TILE_HISTORY_ROWS 256 // rows kept in each tile's streaming texture
+#define GRID_ROW_DURATION_MS 16 // about one row per frame
+#define GRID_ROW_SIM_BUDGET_MS 4 // wall-clock simulation time per row and tile, tiles get fewer steps per row when they outnumber the cores
+#define GRID_MAX_TILES 256
 
 //void DrawCircle(SDL_Renderer* renderer, int32_t centreX, int32_t centreY, int32_t radius);
 //void DrawHollowCircle(SDL_Renderer* renderer, int32_t centreX, int32_t centreY, int32_t radius);
 //void draw_customer_locations(SDL_Renderer* m_window_renderer, cvrptw_problem_t problem, unsigned int window_width, unsigned int window_height, ready_time_t t);
 //void draw_vehicle_locations(SDL_Renderer* m_windows_renderer, cvrptw_problem_t problem, cvrptw_solution_t sol, unsigned int window_width, unsigned int window_height, ready_time_t t);
 void animate_tm(turing_machine_t* tm);
+void animate_tm_adaptive(turing_machine_t* tm);
 int display_tm_visualization_window();
-void load_visualization_tm(char* tm_path);
\ No newline at end of file
+void load_visualization_tm(char* tm_path, tm_tape_numeric_t tape_length);
+void load_visualization_tm_grid(char** tm_paths, unsigned int num_tms, tm_tape_numeric_t tape_length);